@@ -0,0 +1,38 @@
+/**
+ * example.c - Sample module for the runtime loader (src/loader.h)
+ *
+ * Built as a relocatable object (see MODULE_CFLAGS in the Makefile) and
+ * embedded into the image by src/module_blobs.S. Exercises data/bss
+ * references, calls inside the module and an import from the image (strlen).
+ */
+
+#include "loader.h"
+#include <string.h>
+
+static int32_t scale = 3;     // .data
+static int32_t call_count;    // .bss
+
+static int32_t scaled(int32_t value) { return value * scale; }
+
+int32_t module_scaled_sum(int32_t a, int32_t b) {
+  call_count++;
+  return scaled(a + b);
+}
+
+double module_dot2(double x1, double y1, double x2, double y2) {
+  call_count++;
+  return x1 * x2 + y1 * y2;
+}
+
+int32_t module_string_length(const char *s) {
+  call_count++;
+  return (int32_t)strlen(s);
+}
+
+int32_t module_call_count(void) { return call_count; }
+
+UC_MODULE_EXPORT(module_scaled_sum, RET_INT, ARG_INT, ARG_INT);
+UC_MODULE_EXPORT(module_dot2, RET_DOUBLE, ARG_DOUBLE, ARG_DOUBLE, ARG_DOUBLE,
+                 ARG_DOUBLE);
+UC_MODULE_EXPORT(module_string_length, RET_INT, ARG_POINTER);
+UC_MODULE_EXPORT(module_call_count, RET_INT);
@@ -0,0 +1,133 @@
+#include "sigspace.h"
+#include <stdbool.h>
+#include <stdio.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#define SIGSPACE_REPEAT 8     // 每种调用方式的计时次数 (取最小值)
+#define SIGSPACE_MAX_CLASSES 64
+
+volatile uint64_t sigspace_sink;
+
+static inline uint64_t sigspace_cycles(void) {
+#if defined(__x86_64__)
+  return __rdtsc();
+#elif __riscv_xlen == 32
+  uint32_t hi, lo, hi2;
+  do { // 低位进位时重读
+    asm volatile("csrr %0, mcycleh" : "=r"(hi));
+    asm volatile("csrr %0, mcycle" : "=r"(lo));
+    asm volatile("csrr %0, mcycleh" : "=r"(hi2));
+  } while (hi != hi2);
+  return ((uint64_t)hi << 32) | lo;
+#else
+  uint64_t cycles;
+  asm volatile("csrr %0, mcycle" : "=r"(cycles));
+  return cycles;
+#endif
+}
+
+// 按返回类型的宽度逐位比较
+static bool sigspace_ret_equal(ret_type_t type, const return_value_t *a,
+                               const return_value_t *b) {
+  switch (type) {
+  case RET_VOID:
+    return true;
+  case RET_CHAR:
+    return (uint8_t)a->c == (uint8_t)b->c;
+  case RET_SHORT:
+    return (uint16_t)a->s == (uint16_t)b->s;
+  case RET_INT:
+  case RET_FLOAT: // 位模式 (i 与 f 共享低32位)
+    return (uint32_t)a->i == (uint32_t)b->i;
+  case RET_LONG:
+    return a->l == b->l;
+  case RET_LONG_LONG:
+  case RET_DOUBLE: // 位模式 (ll 与 d 共享)
+    return a->ll == b->ll;
+  case RET_POINTER:
+    return a->p == b->p;
+#if UC_HAS_INT128
+  case RET_INT128:
+    return a->i128 == b->i128;
+#endif
+  default:
+    return false;
+  }
+}
+
+typedef struct {
+  uint32_t count;
+  uint64_t universal; // 各签名最小周期数之和
+  uint64_t direct;
+} sigspace_class_stats_t;
+
+int main(void) {
+  static sigspace_class_stats_t stats[SIGSPACE_MAX_CLASSES];
+  uint32_t mismatches = 0;
+
+  printf("\n=== Signature space: seed %lu, %lu signatures ===\n",
+         (unsigned long)sigspace_seed, (unsigned long)sigspace_case_count);
+
+  for (uint32_t n = 0; n < sigspace_case_count; n++) {
+    sigspace_case_t *c = &sigspace_cases[n];
+    return_value_t via_caller = {0}, via_direct = {0};
+    uint64_t best_caller = UINT64_MAX, best_direct = UINT64_MAX;
+    uint64_t sink_caller = 0, sink_direct = 0;
+
+    for (uint32_t r = 0; r < SIGSPACE_REPEAT; r++) {
+      sigspace_sink = 0;
+      uint64_t t0 = sigspace_cycles();
+      via_caller = universal_caller(&c->func);
+      uint64_t t1 = sigspace_cycles();
+      sink_caller = sigspace_sink;
+      if (t1 - t0 < best_caller) {
+        best_caller = t1 - t0;
+      }
+
+      sigspace_sink = 0;
+      t0 = sigspace_cycles();
+      c->direct(&via_direct);
+      t1 = sigspace_cycles();
+      sink_direct = sigspace_sink;
+      if (t1 - t0 < best_direct) {
+        best_direct = t1 - t0;
+      }
+    }
+
+    if (sink_caller != sink_direct ||
+        !sigspace_ret_equal(c->func.ret_type, &via_caller, &via_direct)) {
+      mismatches++;
+      printf("✗ #%lu %s [%s]: args 0x%llx/0x%llx, ret 0x%llx/0x%llx\n",
+             (unsigned long)n, c->signature, sigspace_classes[c->class_id],
+             (unsigned long long)sink_caller, (unsigned long long)sink_direct,
+             (unsigned long long)via_caller.ll,
+             (unsigned long long)via_direct.ll);
+    }
+    if (c->class_id < SIGSPACE_MAX_CLASSES) {
+      stats[c->class_id].count++;
+      stats[c->class_id].universal += best_caller;
+      stats[c->class_id].direct += best_direct;
+    }
+  }
+
+  // 每类签名的平均周期数: universal_caller 与直接调用
+  printf("\n%-28s %8s %12s %12s %10s\n", "class", "count", "caller_cyc",
+         "direct_cyc", "overhead");
+  for (uint32_t k = 0; k < sigspace_class_count && k < SIGSPACE_MAX_CLASSES;
+       k++) {
+    if (stats[k].count == 0) {
+      continue;
+    }
+    unsigned long caller = stats[k].universal / stats[k].count;
+    unsigned long direct = stats[k].direct / stats[k].count;
+    printf("%-28s %8lu %12lu %12lu %10ld\n", sigspace_classes[k],
+           (unsigned long)stats[k].count, caller, direct,
+           (long)(caller - direct));
+  }
+
+  printf("\n=== %lu mismatches in %lu signatures ===\n",
+         (unsigned long)mismatches, (unsigned long)sigspace_case_count);
+  return mismatches;
+}
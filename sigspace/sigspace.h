@@ -0,0 +1,71 @@
+/**
+ * sigspace.h - Randomised signature-space test and benchmark
+ *
+ * tools/gen_sigspace.py generates one callee per random signature, a direct
+ * call of it with fixed argument values and a func_t descriptor with the same
+ * values (make sigspace SEED=... COUNT=...). The driver (driver.c) calls each
+ * signature both ways and compares the results bit for bit. Every callee
+ * hashes all of its argument bits into sigspace_sink and returns a value
+ * derived from the hash, so a misplaced, truncated or badly extended argument
+ * shows up as a mismatch. The driver also reports the cycle cost of both call
+ * paths for each signature class (which registers and stack slots are used).
+ */
+
+#ifndef SIGSPACE_H
+#define SIGSPACE_H
+
+#include "universal_caller.h"
+#include <string.h>
+
+/**
+ * One generated signature
+ */
+typedef struct {
+  const char *signature; // 例如 "double(int, float, long long)"
+  uint32_t class_id;     // sigspace_classes[] 序号
+  func_t func;           // 描述符 (参数值与直接调用相同)
+  void (*direct)(return_value_t *ret); // 直接调用被调函数，结果写入 ret
+} sigspace_case_t;
+
+extern sigspace_case_t sigspace_cases[];
+extern const uint32_t sigspace_case_count;
+extern const char *const sigspace_classes[];
+extern const uint32_t sigspace_class_count;
+extern const uint32_t sigspace_seed;
+
+// 被调函数写入的参数散列值
+extern volatile uint64_t sigspace_sink;
+
+static inline uint64_t sigspace_mix(uint64_t h, uint64_t v) {
+  h = (h ^ v) * 0x100000001B3ull;
+  return h ^ (h >> 29);
+}
+
+static inline uint64_t sigspace_float_bits(float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, 4);
+  return bits;
+}
+
+static inline uint64_t sigspace_double_bits(double d) {
+  uint64_t bits;
+  memcpy(&bits, &d, 8);
+  return bits;
+}
+
+// 由散列值构造有限的浮点数 (符号随机，绝对值在 [1, 2) 内)，便于逐位比较
+static inline float sigspace_make_float(uint64_t h) {
+  uint32_t bits = ((uint32_t)h & 0x807FFFFFu) | 0x3F800000u;
+  float f;
+  memcpy(&f, &bits, 4);
+  return f;
+}
+
+static inline double sigspace_make_double(uint64_t h) {
+  uint64_t bits = (h & 0x800FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
+  double d;
+  memcpy(&d, &bits, 8);
+  return d;
+}
+
+#endif /* SIGSPACE_H */
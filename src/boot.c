@@ -0,0 +1,30 @@
+#include "boot.h"
+#include "trap.h"
+#include <stdio.h>
+
+uxlen_t boot_stamps[BOOT_STAMP_COUNT];
+
+void boot_mark_ready(void) {
+  if (boot_stamps[BOOT_STAMP_READY] == 0) {
+    boot_stamps[BOOT_STAMP_READY] = (uxlen_t)timer_now();
+  }
+}
+
+static inline unsigned long ticks_to_us(uxlen_t ticks) {
+  return (unsigned long)((uint64_t)ticks * 1000000 / CLINT_TIMEBASE_HZ);
+}
+
+void boot_report(void) {
+  static const char *const phases[BOOT_STAMP_COUNT] = {
+      "reset -> _start", "zero .bss", "copy .data", "-> main", "main -> ready"};
+
+  boot_mark_ready(); // 未标记时以当前时刻为准
+  printf("Boot phases (us):\n");
+  uxlen_t prev = 0; // mtime 在复位时为 0
+  for (uint32_t i = 0; i < BOOT_STAMP_COUNT; i++) {
+    printf("  %-16s %8lu\n", phases[i], ticks_to_us(boot_stamps[i] - prev));
+    prev = boot_stamps[i];
+  }
+  printf("  %-16s %8lu\n", "reset -> ready",
+         ticks_to_us(boot_stamps[BOOT_STAMP_READY]));
+}
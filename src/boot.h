@@ -0,0 +1,49 @@
+/**
+ * boot.h - Boot-phase timestamps and the "ready for calls" marker
+ *
+ * start.S records the CLINT mtime (0 at reset, CLINT_TIMEBASE_HZ) on entry,
+ * after zeroing .bss, after the .data copy and right before main.
+ * boot_mark_ready() adds the moment the image can take calls, and
+ * boot_report() prints the time spent in each phase.
+ *
+ * Large buffers whose initial contents are never read can be declared
+ * UC_NOINIT. They go into .noinit, which start.S does not zero.
+ */
+
+#ifndef BOOT_H
+#define BOOT_H
+
+// boot_stamps[] 序号 (start.S 与 C 共用)
+#define BOOT_STAMP_ENTRY 0 // _start 第一条指令
+#define BOOT_STAMP_BSS 1   // .bss 清零完成
+#define BOOT_STAMP_DATA 2  // .data 搬运完成 (LMA == VMA 时跳过)
+#define BOOT_STAMP_MAIN 3  // 调用 main 之前
+#define BOOT_STAMP_READY 4 // boot_mark_ready()
+#define BOOT_STAMP_COUNT 5
+
+#ifndef __ASSEMBLER__
+#if (__riscv == 1)
+#define UC_HAS_BOOT_STAMPS 1
+#define UC_NOINIT __attribute__((section(".noinit")))
+
+#include "riscv_abi.h"
+
+// mtime 的低 XLEN 位 (rv32 上约 429 秒回绕，足以覆盖启动过程)
+extern uxlen_t boot_stamps[BOOT_STAMP_COUNT];
+
+/**
+ * Record that the image is ready for calls (only the first call counts)
+ */
+void boot_mark_ready(void);
+
+/**
+ * Print the boot phases and the total time from reset to ready in µs
+ */
+void boot_report(void);
+#else
+#define UC_HAS_BOOT_STAMPS 0
+#define UC_NOINIT
+#endif
+#endif /* __ASSEMBLER__ */
+
+#endif /* BOOT_H */
@@ -0,0 +1,87 @@
+#include "budget.h"
+#include "trap.h"
+#include <setjmp.h>
+#include <stdbool.h>
+#include <string.h>
+
+static timer_client_t budget_timer;
+static bool budget_registered = false;
+static volatile bool budget_active = false; // 预算调用进行中
+// budget_invoke() 调用 universal_caller() 时的 sp, 0 表示尚未进入
+static volatile uintptr_t budget_call_sp;
+static jmp_buf budget_env;
+static budget_stats_t budget_stats;
+
+// mret 返回到此处 (已恢复中断)，运行在被放弃的被调函数的栈上
+__attribute__((noreturn)) static void budget_abort(void) {
+  longjmp(budget_env, 1);
+}
+
+/**
+ * universal_caller() 与被调函数的栈帧都位于 budget_call_sp 之下，
+ * 据此区分中断点是否在调用内部
+ */
+__attribute__((noinline)) static void budget_invoke(func_t *func,
+                                                    return_value_t *value) {
+  uintptr_t sp;
+  asm volatile("mv %0, sp" : "=r"(sp));
+  budget_call_sp = sp;
+  *value = universal_caller(func);
+}
+
+static void budget_expired(timer_client_t *client, trap_frame_t *frame) {
+  if (!budget_active) { // 调用已结束
+    return;
+  }
+  if (budget_call_sp == 0 || frame->x[2] >= budget_call_sp) {
+    // 尚未进入或已从 universal_caller() 返回: 已返回的调用不能再放弃，
+    // 稍后重新检查 (若尚未进入，下次中断时会位于调用内部)
+    timer_arm(client, timer_now() + BUDGET_RECHECK_TICKS);
+    return;
+  }
+  budget_active = false;
+  frame->mepc = (uxlen_t)(uintptr_t)budget_abort;
+}
+
+call_status_t universal_caller_budgeted(func_t *func, return_value_t *result) {
+  if (func->time_budget == 0) {
+    *result = universal_caller(func);
+    return CALL_OK;
+  }
+  if (budget_active) {
+    return CALL_ERR_NESTED;
+  }
+  if (!budget_registered) {
+    trap_init();
+    timer_register(&budget_timer, budget_expired);
+    budget_registered = true;
+  }
+
+  budget_stats.calls++;
+  if (setjmp(budget_env) != 0) {
+    budget_stats.overruns++; // 计时器已在中断中解除
+    return CALL_TIMEOUT;
+  }
+
+  return_value_t value;
+  budget_call_sp = 0;
+  uint64_t start = timer_now();
+  budget_active = true;
+  timer_arm(&budget_timer, start + func->time_budget);
+  budget_invoke(func, &value);
+  budget_active = false; // 此后中断处理程序不再重新启动计时器
+  timer_disarm(&budget_timer);
+
+  uint64_t elapsed = timer_now() - start;
+  if (elapsed > budget_stats.max_ticks) {
+    budget_stats.max_ticks = elapsed;
+  }
+  *result = value;
+  return CALL_OK;
+}
+
+void budget_get_stats(budget_stats_t *stats) { *stats = budget_stats; }
+
+void budget_reset_stats(void) {
+  memset(&budget_stats, 0, sizeof(budget_stats));
+}
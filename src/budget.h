@@ -0,0 +1,62 @@
+/**
+ * budget.h - Per-call time budgets enforced by the machine timer
+ *
+ * universal_caller_budgeted() arms a timer client (trap.h) for
+ * func->time_budget mtime ticks before the call. If the callee is still
+ * running when the deadline passes, the timer interrupt sets mepc to an abort
+ * stub. After mret, the stub longjmp()s back to the context saved before the
+ * call, which restores sp (including the stack arguments pushed by
+ * universal_caller()) and the callee-saved registers. The call then reports
+ * CALL_TIMEOUT. A deadline that passes after universal_caller() has returned
+ * (or before it is entered) does not abandon anything: the handler looks at
+ * the interrupted sp and checks again BUDGET_RECHECK_TICKS later, so a call
+ * that finished is always reported as CALL_OK with its result.
+ *
+ * The abandoned callee does not run any cleanup, so it must not be stopped in
+ * the middle of state that has to stay consistent (heap, shared buffers). A
+ * callee that runs with interrupts disabled cannot be stopped.
+ */
+
+#ifndef BUDGET_H
+#define BUDGET_H
+
+#include "universal_caller.h"
+
+#define BUDGET_RECHECK_TICKS 10 // 截止时中断点不在调用内部时，再次检查的间隔
+
+#if (__riscv == 1)
+#define UC_HAS_BUDGET 1
+#else
+#define UC_HAS_BUDGET 0
+#endif
+
+typedef enum {
+  CALL_OK = 0,
+  CALL_TIMEOUT,    // 超出 time_budget，调用被放弃
+  CALL_ERR_NESTED, // 预算调用的被调函数内不能再发起预算调用
+} call_status_t;
+
+typedef struct {
+  uint32_t calls;     // 设置了预算的调用次数
+  uint32_t overruns;  // 其中超时被放弃的次数
+  uint64_t max_ticks; // 按时完成的调用中最长的耗时 (mtime ticks)
+} budget_stats_t;
+
+/**
+ * Call a function, abandoning it once func->time_budget mtime ticks have
+ * passed (0: no budget, same as universal_caller())
+ *
+ * @param func   Function descriptor
+ * @param result Return value, written only when CALL_OK is returned
+ * @return CALL_OK, CALL_TIMEOUT or CALL_ERR_NESTED
+ */
+call_status_t universal_caller_budgeted(func_t *func, return_value_t *result);
+
+/**
+ * Copy the counters accumulated since startup or the last reset
+ */
+void budget_get_stats(budget_stats_t *stats);
+
+void budget_reset_stats(void);
+
+#endif /* BUDGET_H */
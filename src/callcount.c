@@ -0,0 +1,58 @@
+#include "callcount.h"
+#include <stdio.h>
+
+// 插桩钩子及其调用的代码本身不能被插桩
+#define NO_INSTRUMENT __attribute__((no_instrument_function))
+
+typedef struct {
+  uintptr_t func;
+  uint32_t count;
+} callcount_entry_t;
+
+static callcount_entry_t callcount_table[CALLCOUNT_SLOTS];
+static uint32_t callcount_dropped; // 表满后未统计的调用
+
+/**
+ * 函数入口钩子: 开放寻址散列表，按函数地址计数
+ * 中断处理中的调用可能与被中断的插入交错，最多丢失个别计数
+ */
+NO_INSTRUMENT void __cyg_profile_func_enter(void *func, void *call_site) {
+  (void)call_site;
+  uintptr_t key = (uintptr_t)func;
+  uint32_t slot =
+      ((uint32_t)key >> 1) * 2654435761u >> (32 - CALLCOUNT_SLOTS_LOG2);
+  for (uint32_t probe = 0; probe < CALLCOUNT_SLOTS; probe++, slot++) {
+    callcount_entry_t *entry = &callcount_table[slot & (CALLCOUNT_SLOTS - 1)];
+    if (entry->func == key) {
+      entry->count++;
+      return;
+    }
+    if (entry->func == 0) {
+      entry->func = key;
+      entry->count = 1;
+      return;
+    }
+  }
+  callcount_dropped++;
+}
+
+NO_INSTRUMENT void __cyg_profile_func_exit(void *func, void *call_site) {
+  (void)func;
+  (void)call_site;
+}
+
+NO_INSTRUMENT void callcount_dump(void) {
+  uint32_t functions = 0;
+  for (uint32_t i = 0; i < CALLCOUNT_SLOTS; i++) {
+    functions += callcount_table[i].func != 0;
+  }
+  printf("CALLS-BEGIN functions=%lu dropped=%lu\n", (unsigned long)functions,
+         (unsigned long)callcount_dropped);
+  for (uint32_t i = 0; i < CALLCOUNT_SLOTS; i++) {
+    if (callcount_table[i].func != 0) {
+      printf("CALLS %lx %lu\n", (unsigned long)callcount_table[i].func,
+             (unsigned long)callcount_table[i].count);
+    }
+  }
+  printf("CALLS-END\n");
+}
@@ -0,0 +1,27 @@
+/**
+ * callcount.h - Per-function call counts for profile-guided code layout
+ *
+ * With CALLCOUNT=1 every function is built with -finstrument-functions, and
+ * the entry hook counts calls per function address in a fixed hash table.
+ * Functions reached through universal_caller() are counted like direct
+ * calls. callcount_dump() prints the table, and tools/gen_hot_order.py turns
+ * it into the hot_order.ld linker ordering file (make pgo).
+ */
+
+#ifndef CALLCOUNT_H
+#define CALLCOUNT_H
+
+#include <stdint.h>
+
+#define CALLCOUNT_SLOTS_LOG2 10
+#define CALLCOUNT_SLOTS (1u << CALLCOUNT_SLOTS_LOG2) // 可统计的函数数量
+
+/**
+ * Print the counted functions:
+ *   CALLS-BEGIN functions=<n> dropped=<n>
+ *   CALLS <function address> <count>
+ *   CALLS-END
+ */
+void callcount_dump(void);
+
+#endif /* CALLCOUNT_H */
@@ -0,0 +1,221 @@
+#include "chain.h"
+#include <stdbool.h>
+
+static inline bool is_floating(ret_type_t type) {
+  return type == RET_FLOAT || type == RET_DOUBLE;
+}
+
+long long chain_value_int(const chain_value_t *value) {
+  switch (value->type) {
+  case RET_CHAR:
+    return value->value.c;
+  case RET_SHORT:
+    return value->value.s;
+  case RET_INT:
+    return value->value.i;
+  case RET_LONG:
+    return value->value.l;
+  case RET_LONG_LONG:
+    return value->value.ll;
+  case RET_FLOAT:
+    return (long long)value->value.f;
+  case RET_DOUBLE:
+    return (long long)value->value.d;
+  case RET_POINTER:
+    return (long long)(intptr_t)value->value.p;
+#if UC_HAS_INT128
+  case RET_INT128:
+    return (long long)value->value.i128;
+#endif
+  default: // RET_VOID
+    return 0;
+  }
+}
+
+double chain_value_double(const chain_value_t *value) {
+  switch (value->type) {
+  case RET_FLOAT:
+    return value->value.f;
+  case RET_DOUBLE:
+    return value->value.d;
+  default:
+    return (double)chain_value_int(value);
+  }
+}
+
+static inline bool chain_value_true(const chain_value_t *value) {
+  return is_floating(value->type) ? chain_value_double(value) != 0.0
+                                  : chain_value_int(value) != 0;
+}
+
+/**
+ * 取操作数的值，槽位序号越界时返回 NULL
+ */
+static const chain_value_t *operand_value(const chain_state_t *state,
+                                          const chain_operand_t *operand) {
+  switch (operand->src) {
+  case CHAIN_SRC_CONST:
+    return &operand->value;
+  case CHAIN_SRC_RESULT:
+    return operand->index < CHAIN_MAX_RESULTS ? &state->results[operand->index]
+                                              : NULL;
+  case CHAIN_SRC_SCRATCH:
+    return operand->index < CHAIN_MAX_SCRATCH ? &state->scratch[operand->index]
+                                              : NULL;
+  default:
+    return NULL;
+  }
+}
+
+// 按参数类型转换 (同 C 赋值语义)
+static void convert_arg(const chain_value_t *value, arg_t *arg) {
+  switch (arg->type) {
+  case ARG_CHAR:
+    arg->value.c = (char)chain_value_int(value);
+    break;
+  case ARG_SHORT:
+    arg->value.s = (short)chain_value_int(value);
+    break;
+  case ARG_INT:
+    arg->value.i = (int32_t)chain_value_int(value);
+    break;
+  case ARG_LONG:
+    arg->value.l = (long)chain_value_int(value);
+    break;
+  case ARG_LONG_LONG:
+    arg->value.ll = chain_value_int(value);
+    break;
+  case ARG_FLOAT:
+    arg->value.f = (float)chain_value_double(value);
+    break;
+  case ARG_DOUBLE:
+    arg->value.d = chain_value_double(value);
+    break;
+  case ARG_POINTER:
+    arg->value.p = value->type == RET_POINTER
+                       ? value->value.p
+                       : (void *)(intptr_t)chain_value_int(value);
+    break;
+#if UC_HAS_INT128
+  case ARG_INT128:
+    arg->value.i128 = value->type == RET_INT128 ? value->value.i128
+                                                : chain_value_int(value);
+    break;
+#endif
+  default:
+    break;
+  }
+}
+
+static chain_status_t chain_call(const chain_insn_t *insn,
+                                 chain_state_t *state) {
+  const func_t *tmpl = insn->func;
+  if (tmpl == NULL || insn->dst >= CHAIN_MAX_RESULTS) {
+    return CHAIN_ERR_INSN;
+  }
+  if (tmpl->arg_count < 0 || tmpl->arg_count > CHAIN_MAX_ARGS) {
+    return CHAIN_ERR_ARGS;
+  }
+
+  arg_t args[CHAIN_MAX_ARGS];
+  for (int32_t i = 0; i < tmpl->arg_count; i++) {
+    args[i] = tmpl->args[i];
+    if (insn->operands != NULL) {
+      const chain_value_t *value = operand_value(state, &insn->operands[i]);
+      if (value == NULL) {
+        return CHAIN_ERR_INSN;
+      }
+      convert_arg(value, &args[i]);
+    }
+  }
+
+  func_t call = *tmpl;
+  call.args = args;
+  state->results[insn->dst].type = tmpl->ret_type;
+  state->results[insn->dst].value = universal_caller(&call);
+  state->calls++;
+  return CHAIN_OK;
+}
+
+chain_status_t chain_run(const chain_program_t *program, chain_state_t *state) {
+  uint32_t max_steps =
+      program->max_steps ? program->max_steps : CHAIN_DEFAULT_MAX_STEPS;
+  uint32_t pc = 0;
+
+  state->output_count = 0;
+  state->steps = 0;
+  state->calls = 0;
+
+  while (pc < program->insn_count) {
+    if (state->steps++ >= max_steps) {
+      return CHAIN_ERR_STEP_LIMIT;
+    }
+    const chain_insn_t *insn = &program->insns[pc++];
+    const chain_value_t *a = operand_value(state, &insn->a);
+    const chain_value_t *b = operand_value(state, &insn->b);
+    bool jump = false;
+
+    switch (insn->op) {
+    case CHAIN_OP_CALL: {
+      chain_status_t status = chain_call(insn, state);
+      if (status != CHAIN_OK) {
+        return status;
+      }
+      break;
+    }
+    case CHAIN_OP_SET:
+      if (a == NULL || insn->dst >= CHAIN_MAX_SCRATCH) {
+        return CHAIN_ERR_INSN;
+      }
+      state->scratch[insn->dst] = *a;
+      break;
+    case CHAIN_OP_ADD:
+      if (a == NULL || b == NULL || insn->dst >= CHAIN_MAX_SCRATCH) {
+        return CHAIN_ERR_INSN;
+      }
+      state->scratch[insn->dst].value.ll =
+          chain_value_int(a) + chain_value_int(b);
+      state->scratch[insn->dst].type = RET_LONG_LONG;
+      break;
+    case CHAIN_OP_JMP:
+      jump = true;
+      break;
+    case CHAIN_OP_JZ:
+    case CHAIN_OP_JNZ:
+      if (a == NULL) {
+        return CHAIN_ERR_INSN;
+      }
+      jump = chain_value_true(a) == (insn->op == CHAIN_OP_JNZ);
+      break;
+    case CHAIN_OP_JLT:
+      if (a == NULL || b == NULL) {
+        return CHAIN_ERR_INSN;
+      }
+      jump = (is_floating(a->type) || is_floating(b->type))
+                 ? chain_value_double(a) < chain_value_double(b)
+                 : chain_value_int(a) < chain_value_int(b);
+      break;
+    case CHAIN_OP_EMIT:
+      if (a == NULL) {
+        return CHAIN_ERR_INSN;
+      }
+      if (state->output_count >= CHAIN_MAX_OUTPUT) {
+        return CHAIN_ERR_OUTPUT_FULL;
+      }
+      state->output[state->output_count++] = *a;
+      break;
+    case CHAIN_OP_HALT:
+      return CHAIN_OK;
+    default:
+      return CHAIN_ERR_INSN;
+    }
+
+    if (jump) {
+      if (insn->target >= program->insn_count) {
+        return CHAIN_ERR_INSN;
+      }
+      pc = insn->target;
+    }
+  }
+  return CHAIN_OK;
+}
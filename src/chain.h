@@ -0,0 +1,130 @@
+/**
+ * chain.h - Call-chain programs executed on top of universal_caller()
+ *
+ * A chain is a small array of instructions. CALL instructions invoke a
+ * descriptor, and each argument comes from an operand: a constant, the result
+ * of an earlier call (result slot) or a scratch slot. Conditional and
+ * unconditional jumps allow branches and loops. EMIT appends values to the
+ * output, which is all the caller needs to send back, so a multi-step
+ * operation costs one request instead of one per call.
+ *
+ * Values keep the type they were produced with. An operand passed to an
+ * argument of another type is converted like a C assignment (integer <->
+ * floating-point, integer <-> pointer). Conditions test the value for non-zero.
+ */
+
+#ifndef CHAIN_H
+#define CHAIN_H
+
+#include "universal_caller.h"
+
+#define CHAIN_MAX_RESULTS 16   // 调用结果槽数量
+#define CHAIN_MAX_SCRATCH 16   // 暂存槽数量
+#define CHAIN_MAX_OUTPUT 16    // EMIT 输出的最大数量
+#define CHAIN_MAX_ARGS 20      // CALL 的最大参数数量
+#define CHAIN_DEFAULT_MAX_STEPS 100000 // 防止死循环的默认步数上限
+
+/**
+ * Value with the type it was produced with
+ */
+typedef struct {
+  ret_type_t type;
+  return_value_t value;
+} chain_value_t;
+
+typedef enum : uint32_t {
+  CHAIN_SRC_CONST,   // value
+  CHAIN_SRC_RESULT,  // 结果槽 results[index]
+  CHAIN_SRC_SCRATCH, // 暂存槽 scratch[index]
+} chain_src_t;
+
+typedef struct {
+  chain_src_t src;
+  uint32_t index;
+  chain_value_t value;
+} chain_operand_t;
+
+typedef enum : uint32_t {
+  CHAIN_OP_CALL, // results[dst] = func(operands...)
+  CHAIN_OP_SET,  // scratch[dst] = a
+  CHAIN_OP_ADD,  // scratch[dst] = a + b (整数, long long)
+  CHAIN_OP_JMP,  // goto target
+  CHAIN_OP_JZ,   // if (a == 0) goto target
+  CHAIN_OP_JNZ,  // if (a != 0) goto target
+  CHAIN_OP_JLT,  // if (a < b) goto target (按 double 或 long long 比较)
+  CHAIN_OP_EMIT, // output[output_count++] = a
+  CHAIN_OP_HALT, // 结束
+} chain_opcode_t;
+
+/**
+ * One chain instruction
+ */
+typedef struct {
+  chain_opcode_t op;
+  uint32_t dst;    // CALL: 结果槽; SET/ADD: 暂存槽
+  uint32_t target; // 跳转目标 (指令序号)
+  const func_t *func; // CALL: 函数、返回类型、参数数量与参数类型
+  const chain_operand_t *operands; // CALL: 每个参数一个; NULL 时使用 func 中的值
+  chain_operand_t a, b;
+} chain_insn_t;
+
+typedef struct {
+  const chain_insn_t *insns;
+  uint32_t insn_count;
+  uint32_t max_steps; // 0 表示 CHAIN_DEFAULT_MAX_STEPS
+} chain_program_t;
+
+/**
+ * Execution state; results and scratch slots may be preset by the caller
+ */
+typedef struct {
+  chain_value_t results[CHAIN_MAX_RESULTS];
+  chain_value_t scratch[CHAIN_MAX_SCRATCH];
+  chain_value_t output[CHAIN_MAX_OUTPUT];
+  uint32_t output_count;
+  uint32_t steps; // 已执行的指令数
+  uint32_t calls; // 已执行的 CALL 数
+} chain_state_t;
+
+typedef enum {
+  CHAIN_OK = 0,
+  CHAIN_ERR_INSN,        // 非法操作码、槽位序号或跳转目标
+  CHAIN_ERR_ARGS,        // 参数数量超过 CHAIN_MAX_ARGS
+  CHAIN_ERR_STEP_LIMIT,  // 超过 max_steps
+  CHAIN_ERR_OUTPUT_FULL, // 超过 CHAIN_MAX_OUTPUT
+} chain_status_t;
+
+// 操作数构造
+#define CHAIN_RESULT(n) ((chain_operand_t){.src = CHAIN_SRC_RESULT, .index = (n)})
+#define CHAIN_SCRATCH(n)                                                       \
+  ((chain_operand_t){.src = CHAIN_SRC_SCRATCH, .index = (n)})
+#define CHAIN_CONST_INT(x)                                                     \
+  ((chain_operand_t){.src = CHAIN_SRC_CONST,                                   \
+                     .value = {.type = RET_LONG_LONG, .value = {.ll = (x)}}})
+#define CHAIN_CONST_DOUBLE(x)                                                  \
+  ((chain_operand_t){.src = CHAIN_SRC_CONST,                                   \
+                     .value = {.type = RET_DOUBLE, .value = {.d = (x)}}})
+#define CHAIN_CONST_POINTER(x)                                                 \
+  ((chain_operand_t){.src = CHAIN_SRC_CONST,                                   \
+                     .value = {.type = RET_POINTER, .value = {.p = (x)}}})
+
+/**
+ * Run a chain program from its first instruction until HALT or the end
+ *
+ * @param program Instructions to execute
+ * @param state   Slots and output; output_count/steps/calls are reset
+ * @return CHAIN_OK, or the reason execution stopped
+ */
+chain_status_t chain_run(const chain_program_t *program, chain_state_t *state);
+
+/**
+ * Value as a signed integer (floating-point values are truncated)
+ */
+long long chain_value_int(const chain_value_t *value);
+
+/**
+ * Value as a double
+ */
+double chain_value_double(const chain_value_t *value);
+
+#endif /* CHAIN_H */
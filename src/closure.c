@@ -0,0 +1,301 @@
+#include "closure.h"
+#include "riscv_abi.h"
+#include <assert.h>
+#include <stddef.h>
+
+/**
+ * closure_common 保存的寄存器帧，布局与 closure.h 中 CLOSURE_FRAME_* 一致
+ */
+typedef struct {
+  uxlen_t a[8];   // a0-a7
+  uint64_t fa[8]; // fa0-fa7 (单精度时只用低32位)
+  uxlen_t ra;
+} closure_frame_t;
+_Static_assert(offsetof(closure_frame_t, a) == CLOSURE_FRAME_A,
+               "closure_frame_t.a 偏移错误");
+_Static_assert(offsetof(closure_frame_t, fa) == CLOSURE_FRAME_FA,
+               "closure_frame_t.fa 偏移错误");
+_Static_assert(offsetof(closure_frame_t, ra) == CLOSURE_FRAME_RA,
+               "closure_frame_t.ra 偏移错误");
+_Static_assert(sizeof(closure_frame_t) <= CLOSURE_FRAME_SIZE,
+               "closure_frame_t 超出 CLOSURE_FRAME_SIZE");
+
+typedef struct {
+  closure_handler_t handler; // NULL 表示空闲
+  void *user;
+  ret_type_t ret_type;
+  int32_t arg_count;
+  arg_type_t arg_types[CLOSURE_MAX_ARGS];
+} closure_t;
+
+/**
+ * 按调用约定依次取出参数的游标，与 universal_caller() 的分配顺序互逆
+ */
+typedef struct {
+  closure_frame_t *frame;
+  uxlen_t *stack_args;
+  uint32_t integar_argument_regs_index;
+  uint32_t fp_argument_regs_index;
+  uint32_t stack_args_index;
+} arg_cursor_t;
+
+extern char closure_trampolines[];
+
+static closure_t closure_pool[CLOSURE_POOL_SIZE];
+
+static uxlen_t next_1xlen(arg_cursor_t *cursor) {
+  if (cursor->integar_argument_regs_index < 8) {
+    return cursor->frame->a[cursor->integar_argument_regs_index++];
+  }
+  return cursor->stack_args[cursor->stack_args_index++];
+}
+
+static dxlen_t next_2xlen(arg_cursor_t *cursor) {
+  uxlen_t lo, hi;
+  if (cursor->integar_argument_regs_index <= 6) {
+    lo = cursor->frame->a[cursor->integar_argument_regs_index++];
+    hi = cursor->frame->a[cursor->integar_argument_regs_index++];
+  } else if (cursor->integar_argument_regs_index == 7) {
+    lo = cursor->frame->a[cursor->integar_argument_regs_index++];
+    hi = cursor->stack_args[cursor->stack_args_index++];
+  } else {
+    cursor->stack_args_index =
+        (cursor->stack_args_index + 1) & ~1; // aligned to 2XLEN
+    lo = cursor->stack_args[cursor->stack_args_index++];
+    hi = cursor->stack_args[cursor->stack_args_index++];
+  }
+  return (dxlen_t)(((udxlen_t)hi << (XLEN * 8)) | lo);
+}
+
+#if __riscv_float_abi_soft != 1
+static int next_fp(arg_cursor_t *cursor, uint64_t *raw) {
+  if (cursor->fp_argument_regs_index < 8) {
+    *raw = cursor->frame->fa[cursor->fp_argument_regs_index++];
+    return 1;
+  }
+  return 0;
+}
+#endif
+
+static void decode_arg(arg_cursor_t *cursor, arg_type_t type, arg_t *arg) {
+  arg->type = type;
+  switch (type) {
+  // Integer (narrower than XLEN: low 32 bits)
+  case ARG_CHAR:
+  case ARG_SHORT:
+  case ARG_INT:
+    arg->value.i = (int32_t)next_1xlen(cursor);
+    break;
+  case ARG_LONG:
+    arg->value.l = (long)next_1xlen(cursor);
+    break;
+  case ARG_POINTER:
+    arg->value.p = (void *)(uintptr_t)next_1xlen(cursor);
+    break;
+#if __riscv_xlen == 32
+  case ARG_LONG_LONG:
+    arg->value.ll = next_2xlen(cursor);
+    break;
+#else
+  case ARG_LONG_LONG:
+    arg->value.ll = (int64_t)next_1xlen(cursor);
+    break;
+  case ARG_INT128:
+    arg->value.i128 = next_2xlen(cursor);
+    break;
+#endif
+  // Floating-point: FP registers first (hard-float ABIs), then integer
+  case ARG_FLOAT: {
+#if __riscv_float_abi_soft != 1
+    uint64_t raw;
+    if (next_fp(cursor, &raw)) {
+      arg->value.i = (int32_t)(uint32_t)raw; // NaN-box 的低32位
+      break;
+    }
+#endif
+    arg->value.i = (int32_t)next_1xlen(cursor);
+    break;
+  }
+  case ARG_DOUBLE: {
+#if __riscv_float_abi_double == 1
+    uint64_t raw;
+    if (next_fp(cursor, &raw)) {
+      arg->value.ll = (int64_t)raw;
+      break;
+    }
+#endif
+#if __riscv_xlen == 32
+    arg->value.ll = next_2xlen(cursor);
+#else
+    arg->value.ll = (int64_t)next_1xlen(cursor);
+#endif
+    break;
+  }
+  default:
+    assert(0); // unknown argument type
+  }
+}
+
+static void encode_ret(closure_frame_t *frame, ret_type_t type,
+                       const return_value_t *ret) {
+  switch (type) {
+  case RET_VOID:
+    break;
+  // Integer (sign-extended to XLEN)
+  case RET_CHAR:
+    frame->a[0] = (xlen_t)ret->c;
+    break;
+  case RET_SHORT:
+    frame->a[0] = (xlen_t)ret->s;
+    break;
+  case RET_INT:
+    frame->a[0] = (xlen_t)ret->i;
+    break;
+  case RET_LONG:
+    frame->a[0] = (xlen_t)ret->l;
+    break;
+  case RET_POINTER:
+    frame->a[0] = (uxlen_t)(uintptr_t)ret->p;
+    break;
+#if __riscv_xlen == 32
+  case RET_LONG_LONG:
+    frame->a[0] = ret->_raw32[0];
+    frame->a[1] = ret->_raw32[1];
+    break;
+#else
+  case RET_LONG_LONG:
+    frame->a[0] = (uxlen_t)ret->ll;
+    break;
+  case RET_INT128:
+    frame->a[0] = ret->_raw64[0];
+    frame->a[1] = ret->_raw64[1];
+    break;
+#endif
+  case RET_FLOAT:
+#if __riscv_float_abi_double == 1
+    frame->fa[0] = 0xFFFFFFFF00000000ULL | ret->_raw32[0]; // NaN-boxed
+#elif __riscv_float_abi_single == 1
+    frame->fa[0] = ret->_raw32[0];
+#else
+    frame->a[0] = (xlen_t)(int32_t)ret->_raw32[0];
+#endif
+    break;
+  case RET_DOUBLE:
+#if __riscv_float_abi_double == 1
+    frame->fa[0] = (uint64_t)ret->ll;
+#elif __riscv_xlen == 32
+    frame->a[0] = ret->_raw32[0];
+    frame->a[1] = ret->_raw32[1];
+#else
+    frame->a[0] = (uxlen_t)ret->ll;
+#endif
+    break;
+  default:
+    assert(0); // unknown return type
+  }
+}
+
+/**
+ * Called from closure_common with the saved argument registers
+ *
+ * @param index      Trampoline index (t0)
+ * @param frame      Saved a0-a7/fa0-fa7; a0/a1/fa0 slots receive the result
+ * @param stack_args Caller's outgoing stack arguments (sp at entry)
+ */
+void closure_dispatch(uint32_t index, closure_frame_t *frame,
+                      uxlen_t *stack_args) {
+  assert(index < CLOSURE_POOL_SIZE);
+  closure_t *closure = &closure_pool[index];
+  assert(closure->handler != NULL);
+
+  arg_t args[CLOSURE_MAX_ARGS];
+  arg_cursor_t cursor = {.frame = frame, .stack_args = stack_args};
+  for (int32_t i = 0; i < closure->arg_count; i++) {
+    decode_arg(&cursor, closure->arg_types[i], &args[i]);
+  }
+
+  return_value_t ret = {0};
+  closure->handler(closure->user, args, &ret);
+  encode_ret(frame, closure->ret_type, &ret);
+}
+
+// decode_arg() 能解码的参数类型
+static int arg_type_supported(arg_type_t type) {
+  switch (type) {
+  case ARG_CHAR:
+  case ARG_SHORT:
+  case ARG_INT:
+  case ARG_LONG:
+  case ARG_POINTER:
+  case ARG_LONG_LONG:
+#if __riscv_xlen != 32
+  case ARG_INT128:
+#endif
+  case ARG_FLOAT:
+  case ARG_DOUBLE:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+// encode_ret() 能编码的返回类型
+static int ret_type_supported(ret_type_t type) {
+  switch (type) {
+  case RET_VOID:
+  case RET_CHAR:
+  case RET_SHORT:
+  case RET_INT:
+  case RET_LONG:
+  case RET_POINTER:
+  case RET_LONG_LONG:
+#if __riscv_xlen != 32
+  case RET_INT128:
+#endif
+  case RET_FLOAT:
+  case RET_DOUBLE:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+void *closure_create(ret_type_t ret_type, const arg_type_t *arg_types,
+                     int32_t arg_count, closure_handler_t handler,
+                     void *user) {
+  if (handler == NULL || arg_count < 0 || arg_count > CLOSURE_MAX_ARGS ||
+      (arg_count > 0 && arg_types == NULL) || !ret_type_supported(ret_type)) {
+    return NULL;
+  }
+  // 在占用槽位之前检查签名，否则分发时会落入 decode_arg 的 assert
+  for (int32_t i = 0; i < arg_count; i++) {
+    if (!arg_type_supported(arg_types[i])) {
+      return NULL;
+    }
+  }
+
+  for (uint32_t index = 0; index < CLOSURE_POOL_SIZE; index++) {
+    closure_t *closure = &closure_pool[index];
+    if (closure->handler != NULL) {
+      continue;
+    }
+    closure->user = user;
+    closure->ret_type = ret_type;
+    closure->arg_count = arg_count;
+    for (int32_t i = 0; i < arg_count; i++) {
+      closure->arg_types[i] = arg_types[i];
+    }
+    closure->handler = handler;
+    return closure_trampolines + index * CLOSURE_TRAMPOLINE_SIZE;
+  }
+  return NULL; // pool exhausted
+}
+
+void closure_destroy(void *fn) {
+  uintptr_t offset = (uintptr_t)fn - (uintptr_t)closure_trampolines;
+  if (fn == NULL || offset % CLOSURE_TRAMPOLINE_SIZE != 0 ||
+      offset / CLOSURE_TRAMPOLINE_SIZE >= CLOSURE_POOL_SIZE) {
+    return;
+  }
+  closure_pool[offset / CLOSURE_TRAMPOLINE_SIZE].handler = NULL;
+}
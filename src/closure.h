@@ -0,0 +1,71 @@
+/**
+ * closure.h - Native function pointers that forward into a generic handler
+ *
+ * The reverse direction of universal_caller(): closure_create() returns a
+ * callable function pointer for a given signature. When native code calls it,
+ * a0-a7/fa0-fa7/stack arguments are decoded back into arg_t and passed to
+ * handler(user, args, ret). The handler's return value is placed in a0/a1/fa0.
+ *
+ * Each closure is backed by a fixed trampoline from a preassembled pool
+ * (closure_entry.S), so no code is generated at runtime.
+ * Variadic signatures are not supported.
+ */
+
+#ifndef CLOSURE_H
+#define CLOSURE_H
+
+#define CLOSURE_POOL_SIZE 32      // 可同时存在的闭包数量
+#define CLOSURE_MAX_ARGS 16       // 单个闭包签名的最大参数数量
+#define CLOSURE_TRAMPOLINE_SIZE 8 // addi t0, zero, index; j closure_common
+
+#if (__riscv == 1)
+#define UC_HAS_CLOSURES 1
+#else
+#define UC_HAS_CLOSURES 0
+#endif
+
+#if UC_HAS_CLOSURES
+#include "riscv_abi.h"
+
+// closure_common 在栈上保存的寄存器帧布局 (与 closure.c 中 closure_frame_t 一致)
+#define CLOSURE_FRAME_A 0                      // a0-a7, 每个 XLEN
+#define CLOSURE_FRAME_FA (8 * XLEN)            // fa0-fa7, 每个 8 字节
+#define CLOSURE_FRAME_RA (CLOSURE_FRAME_FA + 64) // ra
+#define CLOSURE_FRAME_SIZE ((CLOSURE_FRAME_RA + XLEN + 15) & ~15)
+#endif
+
+#ifndef __ASSEMBLER__
+#include "universal_caller.h"
+
+/**
+ * Generic handler invoked for every call through a closure
+ *
+ * @param user User pointer given to closure_create()
+ * @param args Decoded arguments, in the types given to closure_create()
+ * @param ret  Zero-initialized; write the field matching the return type
+ */
+typedef void (*closure_handler_t)(void *user, const arg_t *args,
+                                  return_value_t *ret);
+
+/**
+ * Create a native function pointer with the given signature
+ *
+ * @param ret_type  Return type of the generated function
+ * @param arg_types Argument types (copied, at most CLOSURE_MAX_ARGS)
+ * @param arg_count Number of arguments
+ * @param handler   Handler called with the decoded arguments
+ * @param user      Opaque pointer passed to the handler
+ * @return Callable function pointer, or NULL if the pool is exhausted or the
+ *         signature is not supported
+ */
+void *closure_create(ret_type_t ret_type, const arg_type_t *arg_types,
+                     int32_t arg_count, closure_handler_t handler, void *user);
+
+/**
+ * Release a function pointer returned by closure_create()
+ */
+void closure_destroy(void *fn);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* CLOSURE_H */
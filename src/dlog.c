@@ -0,0 +1,29 @@
+#include "dlog.h"
+#include "boot.h"
+#include "uart.h"
+
+uint32_t dlog_ring[DLOG_RING_WORDS] UC_NOINIT; // 只读取 tail..head 之间已写入的部分
+uint32_t dlog_head = 0;
+uint32_t dlog_tail = 0;
+uint32_t dlog_dropped = 0;
+
+// 绕过 _write，避免在二进制数据中插入 '\r'
+static void dlog_put_word(uint32_t word) {
+  for (int i = 0; i < 4; i++) {
+    uart_putc((char)(word >> (i * 8)));
+  }
+}
+
+void dlog_flush(void) {
+  uint32_t head = dlog_head;
+
+  dlog_put_word(DLOG_BLOCK_MAGIC);
+  dlog_put_word(head - dlog_tail);
+  dlog_put_word(dlog_dropped);
+  for (uint32_t i = dlog_tail; i != head; i++) {
+    dlog_put_word(dlog_ring[i & DLOG_RING_MASK]);
+  }
+
+  dlog_tail = head;
+  dlog_dropped = 0;
+}
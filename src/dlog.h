@@ -0,0 +1,116 @@
+/**
+ * dlog.h - Tokenised deferred logging
+ *
+ * DLOG(fmt, ...) keeps the format string out of the loaded image: it is placed
+ * in the non-allocated .dlog_fmt section (see link.ld) and referenced by its
+ * offset there. At runtime only a header word and the raw argument words are
+ * stored into a RAM ring. dlog_flush() sends the ring over the UART as one
+ * binary block, and tools/dlog_decode.py rebuilds the text from the ELF.
+ *
+ * Arguments follow printf promotion: float is stored as double, integers
+ * narrower than int as int. The format is type-checked against the arguments
+ * like printf. "%s" is only decodable for strings in the image (.rodata/.data).
+ */
+
+#ifndef DLOG_H
+#define DLOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DLOG_RING_WORDS 4096 // 16KB, 必须为2的幂
+#define DLOG_RING_MASK (DLOG_RING_WORDS - 1)
+_Static_assert((DLOG_RING_WORDS & DLOG_RING_MASK) == 0,
+               "DLOG_RING_WORDS 必须为2的幂");
+
+// 记录头: 低24位为格式串在 .dlog_fmt 中的偏移，高8位为参数字数
+#define DLOG_ID_MASK 0x00FFFFFFu
+#define DLOG_WORDS_SHIFT 24
+
+// dlog_flush() 输出块的起始标记 "DLG1"
+#define DLOG_BLOCK_MAGIC 0x31474C44u
+
+extern uint32_t dlog_ring[DLOG_RING_WORDS];
+extern uint32_t dlog_head;    // 写入位置 (单调递增，取模使用)
+extern uint32_t dlog_tail;    // 已刷出位置
+extern uint32_t dlog_dropped; // 因空间不足丢弃的记录数
+
+/**
+ * Reserve space for a record of `words` argument words
+ *
+ * @return Ring index of the record header, or UINT32_MAX if the ring is full
+ */
+static inline uint32_t dlog_reserve(uint32_t words) {
+  if (dlog_head - dlog_tail + 1 + words > DLOG_RING_WORDS) {
+    dlog_dropped++;
+    return UINT32_MAX;
+  }
+  return dlog_head;
+}
+
+static inline uint32_t dlog_put_raw(uint32_t index, const void *value,
+                                    uint32_t size) {
+  uint32_t words[2];
+  memcpy(words, value, size);
+  dlog_ring[index++ & DLOG_RING_MASK] = words[0];
+  if (size > 4) {
+    dlog_ring[index++ & DLOG_RING_MASK] = words[1];
+  }
+  return index;
+}
+
+/**
+ * Send all pending records over the UART as one binary block:
+ * magic, word count, dropped count, then the record words (little-endian)
+ */
+void dlog_flush(void);
+
+// 参数按printf的默认提升规则存储: float -> double, char/short -> int
+#define DLOG_PROMOTED(x) _Generic((x) + 0, float: 0.0, default: (x) + 0)
+#define DLOG_ARG_WORDS(x) + (uint32_t)(sizeof(DLOG_PROMOTED(x)) / 4)
+#define DLOG_PUT_ARG(x)                                                        \
+  {                                                                            \
+    __typeof__(DLOG_PROMOTED(x)) dlog_value_ = (x);                            \
+    dlog_index_ = dlog_put_raw(dlog_index_, &dlog_value_, sizeof(dlog_value_)); \
+  }
+
+#define DLOG_FOR_EACH_0(m)
+#define DLOG_FOR_EACH_1(m, a) m(a)
+#define DLOG_FOR_EACH_2(m, a, ...) m(a) DLOG_FOR_EACH_1(m, __VA_ARGS__)
+#define DLOG_FOR_EACH_3(m, a, ...) m(a) DLOG_FOR_EACH_2(m, __VA_ARGS__)
+#define DLOG_FOR_EACH_4(m, a, ...) m(a) DLOG_FOR_EACH_3(m, __VA_ARGS__)
+#define DLOG_FOR_EACH_5(m, a, ...) m(a) DLOG_FOR_EACH_4(m, __VA_ARGS__)
+#define DLOG_FOR_EACH_6(m, a, ...) m(a) DLOG_FOR_EACH_5(m, __VA_ARGS__)
+#define DLOG_FOR_EACH_7(m, a, ...) m(a) DLOG_FOR_EACH_6(m, __VA_ARGS__)
+#define DLOG_FOR_EACH_8(m, a, ...) m(a) DLOG_FOR_EACH_7(m, __VA_ARGS__)
+#define DLOG_SELECT(_0, _1, _2, _3, _4, _5, _6, _7, _8, name, ...) name
+#define DLOG_FOR_EACH(m, ...)                                                  \
+  DLOG_SELECT(_0, ##__VA_ARGS__, DLOG_FOR_EACH_8, DLOG_FOR_EACH_7,             \
+              DLOG_FOR_EACH_6, DLOG_FOR_EACH_5, DLOG_FOR_EACH_4,               \
+              DLOG_FOR_EACH_3, DLOG_FOR_EACH_2, DLOG_FOR_EACH_1,               \
+              DLOG_FOR_EACH_0)                                                 \
+  (m, ##__VA_ARGS__)
+
+/**
+ * Log a printf-style message (at most 8 arguments) without formatting it
+ */
+#define DLOG(fmt, ...)                                                         \
+  do {                                                                         \
+    static const char dlog_fmt_[] __attribute__((section(".dlog_fmt"))) =     \
+        fmt;                                                                   \
+    if (0) {                                                                   \
+      printf(fmt, ##__VA_ARGS__); /* 仅用于格式检查 */                         \
+    }                                                                          \
+    const uint32_t dlog_words_ = 0 DLOG_FOR_EACH(DLOG_ARG_WORDS, ##__VA_ARGS__); \
+    uint32_t dlog_index_ = dlog_reserve(dlog_words_);                          \
+    if (dlog_index_ != UINT32_MAX) {                                           \
+      dlog_ring[dlog_index_++ & DLOG_RING_MASK] =                              \
+          ((uint32_t)(uintptr_t)dlog_fmt_ & DLOG_ID_MASK) |                    \
+          (dlog_words_ << DLOG_WORDS_SHIFT);                                   \
+      DLOG_FOR_EACH(DLOG_PUT_ARG, ##__VA_ARGS__)                               \
+      dlog_head = dlog_index_;                                                 \
+    }                                                                          \
+  } while (0)
+
+#endif /* DLOG_H */
@@ -0,0 +1,649 @@
+#include "loader.h"
+#include "memo.h"
+#include "riscv_abi.h"
+#include "uart.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ELF 定义 (newlib 不提供 elf.h)，仅包含本加载器用到的部分 */
+#define EI_CLASS 4
+#define EI_DATA 5
+#define ELFCLASS32 1
+#define ELFCLASS64 2
+#define ELFDATA2LSB 1
+#define ET_REL 1
+#define EM_RISCV 243
+#define EF_RISCV_FLOAT_ABI 0x0006
+
+#define SHT_SYMTAB 2
+#define SHT_STRTAB 3
+#define SHT_RELA 4
+#define SHT_NOBITS 8
+#define SHF_ALLOC 0x2
+#define SHN_UNDEF 0
+#define SHN_LORESERVE 0xff00
+#define SHN_ABS 0xfff1
+#define SHN_COMMON 0xfff2
+
+#define R_RISCV_32 1
+#define R_RISCV_64 2
+#define R_RISCV_BRANCH 16
+#define R_RISCV_JAL 17
+#define R_RISCV_CALL 18
+#define R_RISCV_CALL_PLT 19
+#define R_RISCV_GOT_HI20 20
+#define R_RISCV_PCREL_HI20 23
+#define R_RISCV_PCREL_LO12_I 24
+#define R_RISCV_PCREL_LO12_S 25
+#define R_RISCV_HI20 26
+#define R_RISCV_LO12_I 27
+#define R_RISCV_LO12_S 28
+#define R_RISCV_ADD32 35
+#define R_RISCV_ADD64 36
+#define R_RISCV_SUB32 39
+#define R_RISCV_SUB64 40
+#define R_RISCV_ALIGN 43
+#define R_RISCV_RELAX 51
+#define R_RISCV_32_PCREL 57
+
+#if __riscv_xlen == 32
+#define LOADER_ELFCLASS ELFCLASS32
+#else
+#define LOADER_ELFCLASS ELFCLASS64
+#endif
+
+#if __riscv_float_abi_double == 1
+#define LOADER_FLOAT_ABI 0x0004
+#elif __riscv_float_abi_single == 1
+#define LOADER_FLOAT_ABI 0x0002
+#else
+#define LOADER_FLOAT_ABI 0x0000
+#endif
+
+// ELF32/ELF64 的文件头与节头字段顺序相同，仅地址/偏移宽度随 XLEN 变化
+typedef struct {
+  uint8_t e_ident[16];
+  uint16_t e_type;
+  uint16_t e_machine;
+  uint32_t e_version;
+  uxlen_t e_entry;
+  uxlen_t e_phoff;
+  uxlen_t e_shoff;
+  uint32_t e_flags;
+  uint16_t e_ehsize;
+  uint16_t e_phentsize;
+  uint16_t e_phnum;
+  uint16_t e_shentsize;
+  uint16_t e_shnum;
+  uint16_t e_shstrndx;
+} elf_ehdr_t;
+
+typedef struct {
+  uint32_t sh_name;
+  uint32_t sh_type;
+  uxlen_t sh_flags;
+  uxlen_t sh_addr;
+  uxlen_t sh_offset;
+  uxlen_t sh_size;
+  uint32_t sh_link;
+  uint32_t sh_info;
+  uxlen_t sh_addralign;
+  uxlen_t sh_entsize;
+} elf_shdr_t;
+
+#if __riscv_xlen == 32
+typedef struct {
+  uint32_t st_name;
+  uint32_t st_value;
+  uint32_t st_size;
+  uint8_t st_info;
+  uint8_t st_other;
+  uint16_t st_shndx;
+} elf_sym_t;
+#define ELF_R_SYM(info) ((info) >> 8)
+#define ELF_R_TYPE(info) ((info) & 0xff)
+#else
+typedef struct {
+  uint32_t st_name;
+  uint8_t st_info;
+  uint8_t st_other;
+  uint16_t st_shndx;
+  uint64_t st_value;
+  uint64_t st_size;
+} elf_sym_t;
+#define ELF_R_SYM(info) ((info) >> 32)
+#define ELF_R_TYPE(info) ((info) & 0xffffffff)
+#endif
+
+typedef struct {
+  uxlen_t r_offset;
+  uxlen_t r_info;
+  xlen_t r_addend;
+} elf_rela_t;
+
+/**
+ * 一次装载过程中的状态
+ */
+typedef struct {
+  const uint8_t *image;
+  const elf_shdr_t *shdrs;
+  uint32_t shnum;
+  const elf_sym_t *symtab;
+  uint32_t symcount;
+  const char *strtab;
+  uxlen_t strsize;
+  uintptr_t *section_addr; // 每个节的装载地址 (非 ALLOC 节为 0)
+  uxlen_t *got;            // GOT_HI20 使用的槽位
+  uint32_t got_used;
+} load_ctx_t;
+
+extern const loader_symbol_t __loader_symtab_start[];
+extern const loader_symbol_t __loader_symtab_end[];
+
+// 模块常用的镜像符号；其他符号可在镜像任意位置用 LOADER_EXPORT() 导出
+LOADER_EXPORT(memcpy);
+LOADER_EXPORT(memmove);
+LOADER_EXPORT(memset);
+LOADER_EXPORT(memcmp);
+LOADER_EXPORT(strlen);
+LOADER_EXPORT(strcmp);
+LOADER_EXPORT(printf);
+LOADER_EXPORT(malloc);
+LOADER_EXPORT(free);
+LOADER_EXPORT(universal_caller);
+
+static loader_module_t loader_modules[LOADER_MAX_MODULES];
+static char loader_undefined[64];
+
+static inline uint32_t read32(uintptr_t addr) {
+  uint32_t value;
+  memcpy(&value, (const void *)addr, sizeof(value));
+  return value;
+}
+
+static inline void write32(uintptr_t addr, uint32_t value) {
+  memcpy((void *)addr, &value, sizeof(value));
+}
+
+static inline void write64(uintptr_t addr, uint64_t value) {
+  memcpy((void *)addr, &value, sizeof(value));
+}
+
+// 立即数编码 (见 RISC-V 非特权规范 2.3 节)
+static inline uint32_t encode_u(uint32_t insn, uxlen_t value) {
+  return (insn & 0x00000fff) | ((uint32_t)(value + 0x800) & 0xfffff000);
+}
+
+static inline uint32_t encode_i(uint32_t insn, uxlen_t value) {
+  return (insn & 0x000fffff) | ((uint32_t)value << 20);
+}
+
+static inline uint32_t encode_s(uint32_t insn, uxlen_t value) {
+  return (insn & 0x01fff07f) | (((uint32_t)value & 0xfe0) << 20) |
+         (((uint32_t)value & 0x1f) << 7);
+}
+
+static inline uint32_t encode_b(uint32_t insn, uxlen_t value) {
+  uint32_t v = (uint32_t)value;
+  return (insn & 0x01fff07f) | ((v >> 12 & 0x1) << 31) |
+         ((v >> 5 & 0x3f) << 25) | ((v >> 1 & 0xf) << 8) | ((v >> 11 & 0x1) << 7);
+}
+
+static inline uint32_t encode_j(uint32_t insn, uxlen_t value) {
+  uint32_t v = (uint32_t)value;
+  return (insn & 0x00000fff) | ((v >> 20 & 0x1) << 31) |
+         ((v >> 1 & 0x3ff) << 21) | ((v >> 11 & 0x1) << 20) | (v & 0xff000);
+}
+
+// 带符号偏移是否可用 bits 位表示
+static inline bool fits_signed(xlen_t value, uint32_t bits) {
+  if (bits >= XLEN * 8) {
+    return true;
+  }
+  xlen_t limit = (xlen_t)1 << (bits - 1);
+  return value >= -limit && value < limit;
+}
+
+// 绝对地址能否存入32位字 (零扩展或符号扩展读取均可)
+// 模块文件不可信: 先比较 offset 再做减法，offset + len 不会回绕
+static inline bool in_bounds(uxlen_t size, uxlen_t offset, uxlen_t len) {
+  return offset <= size && len <= size - offset;
+}
+
+static inline bool fits_32(uxlen_t value) {
+  return (uxlen_t)(uint32_t)value == value || fits_signed((xlen_t)value, 32);
+}
+
+static const void *lookup_image_symbol(const char *name) {
+  for (const loader_symbol_t *s = __loader_symtab_start;
+       s < __loader_symtab_end; s++) {
+    if (strcmp(s->name, name) == 0) {
+      return s->addr;
+    }
+  }
+  return NULL;
+}
+
+static loader_status_t resolve_symbol(load_ctx_t *ctx, uint32_t index,
+                                      uxlen_t *value) {
+  if (index >= ctx->symcount) {
+    return LOADER_ERR_FORMAT;
+  }
+  const elf_sym_t *sym = &ctx->symtab[index];
+  if (sym->st_shndx == SHN_UNDEF) {
+    if (sym->st_name >= ctx->strsize) {
+      return LOADER_ERR_FORMAT; // 字符串表以 NUL 结尾 (check_header)
+    }
+    const char *name = ctx->strtab + sym->st_name;
+    const void *addr = lookup_image_symbol(name);
+    if (addr == NULL) {
+      strncpy(loader_undefined, name, sizeof(loader_undefined) - 1);
+      return LOADER_ERR_UNDEFINED;
+    }
+    *value = (uintptr_t)addr;
+  } else if (sym->st_shndx == SHN_ABS) {
+    *value = sym->st_value;
+  } else if (sym->st_shndx == SHN_COMMON || sym->st_shndx >= SHN_LORESERVE ||
+             sym->st_shndx >= ctx->shnum) {
+    return LOADER_ERR_FORMAT; // 模块需以 -fno-common 编译
+  } else {
+    *value = ctx->section_addr[sym->st_shndx] + sym->st_value;
+  }
+  return LOADER_OK;
+}
+
+/**
+ * 应用一个重定位节
+ *
+ * PCREL_LO12_I/S 的符号指向对应 auipc 所在位置，其值取自该处 HI20 重定位的
+ * 计算结果，因此先处理其他重定位并记录 HI20 的结果，再处理 LO12
+ */
+static loader_status_t apply_rela(load_ctx_t *ctx, const elf_shdr_t *shdr) {
+  const elf_rela_t *relas =
+      (const elf_rela_t *)(ctx->image + shdr->sh_offset);
+  uint32_t count = shdr->sh_size / sizeof(elf_rela_t);
+  uintptr_t target = ctx->section_addr[shdr->sh_info];
+  uxlen_t target_size = ctx->shdrs[shdr->sh_info].sh_size;
+  uxlen_t *hi_values = malloc((count ? count : 1) * sizeof(uxlen_t));
+  if (hi_values == NULL) {
+    return LOADER_ERR_NO_MEMORY;
+  }
+  loader_status_t status = LOADER_OK;
+
+  for (uint32_t pass = 0; pass < 2 && status == LOADER_OK; pass++) {
+    for (uint32_t i = 0; i < count; i++) {
+      const elf_rela_t *rela = &relas[i];
+      uint32_t type = ELF_R_TYPE(rela->r_info);
+      bool is_lo = type == R_RISCV_PCREL_LO12_I || type == R_RISCV_PCREL_LO12_S;
+      if (type == R_RISCV_RELAX || type == R_RISCV_ALIGN ||
+          is_lo != (pass == 1)) {
+        continue; // 不做链接松弛；ALIGN 填充的 nop 保留不删
+      }
+
+      // 被修改的字节 (CALL 为 auipc + jalr 两条指令) 必须位于目标节内
+      uxlen_t width = type == R_RISCV_64 || type == R_RISCV_ADD64 ||
+                              type == R_RISCV_SUB64 || type == R_RISCV_CALL ||
+                              type == R_RISCV_CALL_PLT
+                          ? 8
+                          : 4;
+      if (!in_bounds(target_size, rela->r_offset, width)) {
+        status = LOADER_ERR_FORMAT;
+        break;
+      }
+
+      uxlen_t s;
+      status = resolve_symbol(ctx, ELF_R_SYM(rela->r_info), &s);
+      if (status != LOADER_OK) {
+        break;
+      }
+      uintptr_t p = target + rela->r_offset;
+      uxlen_t value = s + rela->r_addend;
+      xlen_t pcrel = (xlen_t)(value - p);
+
+      switch (type) {
+      case R_RISCV_32:
+        if (!fits_32(value)) {
+          status = LOADER_ERR_RELOC;
+          break;
+        }
+        write32(p, (uint32_t)value);
+        break;
+      case R_RISCV_64:
+        write64(p, (uint64_t)value);
+        break;
+      case R_RISCV_ADD32:
+        write32(p, read32(p) + (uint32_t)value);
+        break;
+      case R_RISCV_SUB32:
+        write32(p, read32(p) - (uint32_t)value);
+        break;
+      case R_RISCV_ADD64:
+      case R_RISCV_SUB64: {
+        uint64_t old;
+        memcpy(&old, (const void *)p, sizeof(old));
+        write64(p, type == R_RISCV_ADD64 ? old + value : old - value);
+        break;
+      }
+      case R_RISCV_32_PCREL:
+        write32(p, (uint32_t)pcrel);
+        break;
+      case R_RISCV_BRANCH:
+        if (!fits_signed(pcrel, 13)) {
+          status = LOADER_ERR_RANGE;
+          break;
+        }
+        write32(p, encode_b(read32(p), pcrel));
+        break;
+      case R_RISCV_JAL:
+        if (!fits_signed(pcrel, 21)) {
+          status = LOADER_ERR_RANGE;
+          break;
+        }
+        write32(p, encode_j(read32(p), pcrel));
+        break;
+      case R_RISCV_CALL:
+      case R_RISCV_CALL_PLT: // auipc + jalr
+        if (!fits_signed(pcrel + 0x800, 32)) {
+          status = LOADER_ERR_RANGE;
+          break;
+        }
+        write32(p, encode_u(read32(p), pcrel));
+        write32(p + 4, encode_i(read32(p + 4), pcrel));
+        break;
+      case R_RISCV_GOT_HI20: // 每个重定位一个槽位，槽位中存放符号地址
+        ctx->got[ctx->got_used] = value;
+        pcrel = (xlen_t)((uintptr_t)&ctx->got[ctx->got_used++] - p);
+        // fall through
+      case R_RISCV_PCREL_HI20:
+        if (!fits_signed(pcrel + 0x800, 32)) {
+          status = LOADER_ERR_RANGE;
+          break;
+        }
+        hi_values[i] = pcrel;
+        write32(p, encode_u(read32(p), pcrel));
+        break;
+      case R_RISCV_PCREL_LO12_I:
+      case R_RISCV_PCREL_LO12_S: {
+        // s 为 auipc 的地址，查找该处的 HI20 重定位
+        uint32_t hi;
+        for (hi = 0; hi < count; hi++) {
+          uint32_t hi_type = ELF_R_TYPE(relas[hi].r_info);
+          if ((hi_type == R_RISCV_PCREL_HI20 || hi_type == R_RISCV_GOT_HI20) &&
+              target + relas[hi].r_offset == s) {
+            break;
+          }
+        }
+        if (hi == count) {
+          status = LOADER_ERR_FORMAT;
+          break;
+        }
+        write32(p, type == R_RISCV_PCREL_LO12_I
+                       ? encode_i(read32(p), hi_values[hi])
+                       : encode_s(read32(p), hi_values[hi]));
+        break;
+      }
+      // lui + addi/load/store: 结果为符号扩展的32位地址，rv64 上位于
+      // 0x80000000 以上的镜像不可达，模块需以 -mcmodel=medany 编译
+      case R_RISCV_HI20:
+      case R_RISCV_LO12_I:
+      case R_RISCV_LO12_S:
+        if (!fits_signed((xlen_t)(value + 0x800), 32)) {
+          status = LOADER_ERR_RELOC;
+          break;
+        }
+        if (type == R_RISCV_HI20) {
+          write32(p, encode_u(read32(p), value));
+        } else if (type == R_RISCV_LO12_I) {
+          write32(p, encode_i(read32(p), value));
+        } else {
+          write32(p, encode_s(read32(p), value));
+        }
+        break;
+      default:
+        status = LOADER_ERR_RELOC;
+        break;
+      }
+      if (status != LOADER_OK) {
+        break;
+      }
+    }
+  }
+
+  free(hi_values);
+  return status;
+}
+
+static loader_status_t check_header(const uint8_t *image, size_t size) {
+  const elf_ehdr_t *ehdr = (const elf_ehdr_t *)image;
+  if (size < sizeof(elf_ehdr_t) || memcmp(ehdr->e_ident, "\177ELF", 4) != 0 ||
+      ehdr->e_ident[EI_CLASS] != LOADER_ELFCLASS ||
+      ehdr->e_ident[EI_DATA] != ELFDATA2LSB || ehdr->e_type != ET_REL ||
+      ehdr->e_machine != EM_RISCV ||
+      (ehdr->e_flags & EF_RISCV_FLOAT_ABI) != LOADER_FLOAT_ABI ||
+      ehdr->e_shentsize != sizeof(elf_shdr_t) ||
+      !in_bounds(size, ehdr->e_shoff,
+                 (uxlen_t)ehdr->e_shnum * sizeof(elf_shdr_t)) ||
+      ehdr->e_shstrndx >= ehdr->e_shnum) {
+    return LOADER_ERR_FORMAT;
+  }
+
+  const elf_shdr_t *shdrs = (const elf_shdr_t *)(image + ehdr->e_shoff);
+  for (uint32_t i = 0; i < ehdr->e_shnum; i++) {
+    const elf_shdr_t *shdr = &shdrs[i];
+    if (shdr->sh_type == SHT_NOBITS) {
+      continue;
+    }
+    if (!in_bounds(size, shdr->sh_offset, shdr->sh_size)) {
+      return LOADER_ERR_FORMAT;
+    }
+    // 名字按 C 字符串读取，字符串表须以 NUL 结尾
+    if (shdr->sh_type == SHT_STRTAB &&
+        (shdr->sh_size == 0 ||
+         image[shdr->sh_offset + shdr->sh_size - 1] != '\0')) {
+      return LOADER_ERR_FORMAT;
+    }
+  }
+  if (shdrs[ehdr->e_shstrndx].sh_type != SHT_STRTAB) {
+    return LOADER_ERR_FORMAT;
+  }
+  return LOADER_OK;
+}
+
+static void fence_i(void) {
+  // fence.i (Zifencei)，以 .insn 编码，不依赖 -march 中的 zifencei
+  asm volatile(".insn i 0x0f, 1, x0, x0, 0" ::: "memory");
+}
+
+loader_status_t loader_load(const void *image, size_t size,
+                            loader_module_t **module) {
+  loader_status_t status = check_header(image, size);
+  if (status != LOADER_OK) {
+    return status;
+  }
+
+  loader_module_t *slot = NULL;
+  for (uint32_t i = 0; i < LOADER_MAX_MODULES; i++) {
+    if (loader_modules[i].memory == NULL) {
+      slot = &loader_modules[i];
+      break;
+    }
+  }
+  if (slot == NULL) {
+    return LOADER_ERR_NO_SLOT;
+  }
+
+  const elf_ehdr_t *ehdr = image;
+  load_ctx_t ctx = {
+      .image = image,
+      .shdrs = (const elf_shdr_t *)((const uint8_t *)image + ehdr->e_shoff),
+      .shnum = ehdr->e_shnum,
+  };
+  const char *shstrtab =
+      (const char *)ctx.image + ctx.shdrs[ehdr->e_shstrndx].sh_offset;
+  uxlen_t shstrsize = ctx.shdrs[ehdr->e_shstrndx].sh_size;
+
+  // 布局: 所有 ALLOC 节依次排列，其后为 GOT 槽位
+  uxlen_t *offsets = calloc(ctx.shnum, sizeof(uxlen_t));
+  ctx.section_addr = calloc(ctx.shnum, sizeof(uintptr_t));
+  if (offsets == NULL || ctx.section_addr == NULL) {
+    status = LOADER_ERR_NO_MEMORY;
+    goto out;
+  }
+  uxlen_t total = 0, max_align = XLEN;
+  uint32_t got_slots = 0;
+  for (uint32_t i = 0; i < ctx.shnum; i++) {
+    const elf_shdr_t *shdr = &ctx.shdrs[i];
+    if (shdr->sh_type == SHT_SYMTAB) {
+      if (shdr->sh_link >= ctx.shnum ||
+          ctx.shdrs[shdr->sh_link].sh_type != SHT_STRTAB) {
+        status = LOADER_ERR_FORMAT;
+        goto out;
+      }
+      ctx.symtab = (const elf_sym_t *)(ctx.image + shdr->sh_offset);
+      ctx.symcount = shdr->sh_size / sizeof(elf_sym_t);
+      ctx.strtab = (const char *)ctx.image + ctx.shdrs[shdr->sh_link].sh_offset;
+      ctx.strsize = ctx.shdrs[shdr->sh_link].sh_size;
+    } else if (shdr->sh_type == SHT_RELA) {
+      const elf_rela_t *relas = (const elf_rela_t *)(ctx.image + shdr->sh_offset);
+      for (uint32_t r = 0; r < shdr->sh_size / sizeof(elf_rela_t); r++) {
+        got_slots += ELF_R_TYPE(relas[r].r_info) == R_RISCV_GOT_HI20;
+      }
+    }
+    if (!(shdr->sh_flags & SHF_ALLOC) || shdr->sh_size == 0) {
+      continue;
+    }
+    uxlen_t align = shdr->sh_addralign ? shdr->sh_addralign : 1;
+    max_align = align > max_align ? align : max_align;
+    total = (total + align - 1) & ~(align - 1);
+    offsets[i] = total;
+    total += shdr->sh_size;
+  }
+  if (ctx.symtab == NULL) {
+    status = LOADER_ERR_FORMAT;
+    goto out;
+  }
+  total = (total + XLEN - 1) & ~(uxlen_t)(XLEN - 1);
+  uxlen_t got_offset = total;
+  total += got_slots * XLEN;
+
+  slot->memory = malloc(total + max_align - 1);
+  if (slot->memory == NULL) {
+    status = LOADER_ERR_NO_MEMORY;
+    goto out;
+  }
+  slot->base = (uint8_t *)(((uintptr_t)slot->memory + max_align - 1) &
+                           ~(uintptr_t)(max_align - 1));
+  slot->size = total;
+  ctx.got = (uxlen_t *)(slot->base + got_offset);
+
+  // 复制内容 / 清零 NOBITS
+  for (uint32_t i = 0; i < ctx.shnum; i++) {
+    const elf_shdr_t *shdr = &ctx.shdrs[i];
+    if (!(shdr->sh_flags & SHF_ALLOC) || shdr->sh_size == 0) {
+      continue;
+    }
+    ctx.section_addr[i] = (uintptr_t)slot->base + offsets[i];
+    if (shdr->sh_type == SHT_NOBITS) {
+      memset((void *)ctx.section_addr[i], 0, shdr->sh_size);
+    } else {
+      memcpy((void *)ctx.section_addr[i], ctx.image + shdr->sh_offset,
+             shdr->sh_size);
+    }
+  }
+
+  // 重定位 (只处理目标为 ALLOC 节的重定位节，调试信息等忽略)
+  for (uint32_t i = 0; i < ctx.shnum; i++) {
+    const elf_shdr_t *shdr = &ctx.shdrs[i];
+    if (shdr->sh_type != SHT_RELA || shdr->sh_info >= ctx.shnum ||
+        ctx.section_addr[shdr->sh_info] == 0) {
+      continue;
+    }
+    status = apply_rela(&ctx, shdr);
+    if (status != LOADER_OK) {
+      goto out;
+    }
+  }
+
+  // 导出表
+  slot->exports = NULL;
+  slot->export_count = 0;
+  for (uint32_t i = 0; i < ctx.shnum; i++) {
+    if (ctx.section_addr[i] != 0 && ctx.shdrs[i].sh_name < shstrsize &&
+        strcmp(shstrtab + ctx.shdrs[i].sh_name, ".uc_exports") == 0) {
+      slot->exports = (const loader_export_t *)ctx.section_addr[i];
+      slot->export_count = ctx.shdrs[i].sh_size / sizeof(loader_export_t);
+    }
+  }
+
+  fence_i();
+  *module = slot;
+
+out:
+  if (status != LOADER_OK && slot->memory != NULL) {
+    free(slot->memory);
+    slot->memory = NULL;
+  }
+  free(offsets);
+  free(ctx.section_addr);
+  return status;
+}
+
+loader_status_t loader_load_uart(loader_module_t **module) {
+  uint32_t size = 0;
+  for (uint32_t i = 0; i < 4; i++) {
+    size |= (uint32_t)(uint8_t)uart_getc() << (8 * i);
+  }
+  uint8_t *buffer = malloc(size ? size : 1); // malloc 对齐满足 XLEN 要求
+  if (buffer == NULL) {
+    return LOADER_ERR_NO_MEMORY;
+  }
+  for (uint32_t i = 0; i < size; i++) {
+    buffer[i] = (uint8_t)uart_getc();
+  }
+  loader_status_t status = loader_load(buffer, size, module);
+  free(buffer);
+  return status;
+}
+
+void loader_unload(loader_module_t *module) {
+  if (module == NULL || module->memory == NULL) {
+    return;
+  }
+  // 缓存以函数地址为键，内存复用后新模块的函数可能落在相同地址
+  memo_invalidate_range(module->base, module->size);
+  free(module->memory);
+  module->memory = NULL;
+  module->base = NULL;
+  module->exports = NULL;
+  module->export_count = 0;
+}
+
+const loader_export_t *loader_find(const loader_module_t *module,
+                                   const char *name) {
+  for (uint32_t i = 0; i < module->export_count; i++) {
+    if (strcmp(module->exports[i].name, name) == 0) {
+      return &module->exports[i];
+    }
+  }
+  return NULL;
+}
+
+loader_status_t loader_bind(const loader_export_t *export, func_t *func,
+                            arg_t *args, uint32_t arg_capacity) {
+  if ((uint32_t)export->arg_count > arg_capacity) {
+    return LOADER_ERR_ARGS;
+  }
+  // 整体赋值，flags 等其余字段不沿用描述符中的旧值
+  *func = (func_t){.func = export->func,
+                   .ret_type = export->ret_type,
+                   .arg_count = export->arg_count,
+                   .args = args};
+  for (int32_t i = 0; i < export->arg_count; i++) {
+    args[i].type = export->arg_types[i];
+  }
+  return LOADER_OK;
+}
+
+const char *loader_undefined_symbol(void) { return loader_undefined; }
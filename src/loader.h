@@ -0,0 +1,136 @@
+/**
+ * loader.h - Runtime loader for relocatable code modules
+ *
+ * loader_load() takes a relocatable ELF object (ET_REL, same XLEN and float
+ * ABI as the image) from any memory buffer. It copies its allocated sections
+ * into heap memory, resolves undefined symbols against the image symbols
+ * exported with LOADER_EXPORT(), applies the relocations and issues fence.i.
+ * Functions the module declares with UC_MODULE_EXPORT() can then be looked up
+ * by name and called through universal_caller().
+ *
+ * Build modules with `-c -mno-relax -fno-common`: linker relaxation is not
+ * performed, and COMMON symbols are rejected. Static constructors are not run.
+ */
+
+#ifndef LOADER_H
+#define LOADER_H
+
+#include "universal_caller.h"
+#include <stddef.h>
+
+#if (__riscv == 1)
+#define UC_HAS_LOADER 1
+#else
+#define UC_HAS_LOADER 0
+#endif
+
+#define LOADER_MAX_MODULES 8 // 可同时装载的模块数量
+
+/**
+ * Exported function of a module, with the signature used to call it
+ * (placed in the module's .uc_exports section by UC_MODULE_EXPORT)
+ */
+typedef struct {
+  const char *name;
+  void *func;
+  ret_type_t ret_type;
+  int32_t arg_count;
+  const arg_type_t *arg_types;
+} loader_export_t;
+
+/**
+ * Image symbol that modules may import (placed in .loader_symtab)
+ */
+typedef struct {
+  const char *name;
+  void *addr;
+} loader_symbol_t;
+
+/**
+ * Export a module function with its signature
+ * e.g. UC_MODULE_EXPORT(add, RET_INT, ARG_INT, ARG_INT);
+ */
+#define UC_MODULE_EXPORT(fn, ret, ...)                                         \
+  static const arg_type_t fn##_uc_arg_types_[] = {__VA_ARGS__};                \
+  static const loader_export_t fn##_uc_export_                                 \
+      __attribute__((section(".uc_exports"), used)) = {                        \
+          #fn, (void *)fn, ret,                                                \
+          (int32_t)(sizeof(fn##_uc_arg_types_) / sizeof(arg_type_t)),          \
+          fn##_uc_arg_types_}
+
+/**
+ * Make an image symbol available to modules
+ */
+#define LOADER_EXPORT(sym)                                                     \
+  static const loader_symbol_t loader_symbol_##sym##_                          \
+      __attribute__((section(".loader_symtab"), used)) = {#sym, (void *)&sym}
+
+typedef enum {
+  LOADER_OK = 0,
+  LOADER_ERR_FORMAT,    // 不是与镜像匹配的可重定位 ELF，或偏移/名字越界
+  LOADER_ERR_NO_MEMORY, // 堆空间不足
+  LOADER_ERR_NO_SLOT,   // 模块表已满
+  LOADER_ERR_UNDEFINED, // 导入符号在镜像中未导出
+  LOADER_ERR_RELOC,     // 不支持的重定位类型，或绝对地址无法以32位表示
+  LOADER_ERR_RANGE,     // 重定位结果超出指令立即数范围
+  LOADER_ERR_ARGS,      // 参数数组容量不足 (loader_bind)
+} loader_status_t;
+
+typedef struct {
+  void *memory;  // malloc 返回的原始指针, NULL 表示空闲
+  uint8_t *base; // 按最大节对齐后的装载基址
+  size_t size;
+  const loader_export_t *exports;
+  uint32_t export_count;
+} loader_module_t;
+
+#if UC_HAS_LOADER
+/**
+ * Load a relocatable module
+ *
+ * @param image  ELF object in memory (XLEN-aligned), only read during the call
+ * @param size   Size of the object in bytes
+ * @param module Receives the loaded module on success
+ * @return LOADER_OK, or the reason the module was rejected
+ */
+loader_status_t loader_load(const void *image, size_t size,
+                            loader_module_t **module);
+
+/**
+ * Receive a module over the UART (32-bit little-endian length, then the
+ * object bytes) and load it
+ */
+loader_status_t loader_load_uart(loader_module_t **module);
+
+/**
+ * Unload a module and return its memory to the heap
+ */
+void loader_unload(loader_module_t *module);
+
+/**
+ * Find an exported function of a module by name
+ *
+ * @return Export entry, or NULL if the module does not export `name`
+ */
+const loader_export_t *loader_find(const loader_module_t *module,
+                                   const char *name);
+
+/**
+ * Fill a descriptor from an export: func, ret_type, arg_count, args and the
+ * type of each argument. All other descriptor fields are zeroed. The caller
+ * fills in the argument values.
+ *
+ * @param arg_capacity Number of entries in args
+ * @return LOADER_OK, or LOADER_ERR_ARGS if the export takes more arguments
+ *         (func and args are left untouched)
+ */
+loader_status_t loader_bind(const loader_export_t *export, func_t *func,
+                            arg_t *args, uint32_t arg_capacity);
+
+/**
+ * Name of the last symbol that failed to resolve (LOADER_ERR_UNDEFINED)
+ */
+const char *loader_undefined_symbol(void);
+#endif
+
+#endif /* LOADER_H */
@@ -1,27 +1,62 @@
+#include "boot.h"
+#include "budget.h"
+#include "callcount.h"
+#include "chain.h"
+#include "closure.h"
+#include "loader.h"
+#include "memo.h"
 #include "universal_caller.h"
+#ifdef USE_DLOG
+#include "dlog.h"
+#endif
+#ifdef USE_PROFILER
+#include "profiler.h"
+#endif
+#ifdef USE_RPC
+#include "rpc.h"
+#endif
 #include <assert.h>
 #include <limits.h>
 #include <math.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef USE_SEMIHOSTING
+#include <unistd.h>
+#endif
+#if UC_HAS_VECTOR
+#include "trap.h"
+#endif
 
 // Include test functions directly
 #include "test_funcs.txt"
 
+// 结果输出: USE_DLOG 时使用延迟日志 (格式串不进入镜像，不在目标端格式化)
+#ifdef USE_DLOG
+#define REPORT(...) DLOG(__VA_ARGS__)
+#else
+#define REPORT(...) printf(__VA_ARGS__)
+#endif
+
 // ANSI颜色代码宏定义
 #define COLOR_RESET "\033[0m"
 #define COLOR_RED "\033[31m"
 #define COLOR_GREEN "\033[32m"
 
+// 失败的用例数，作为main的返回值(原生x86-64构建时即进程退出码)
+static int failures = 0;
+
 /**
  * Print test result and verify against expected value
  */
 static void verify_int32(const char *test_name, int32_t result,
                          int32_t expected) {
   if (result == expected) {
-    printf(COLOR_GREEN "✓ %s: %ld" COLOR_RESET "\n", test_name, (long)result);
+    REPORT(COLOR_GREEN "✓ %s: %ld" COLOR_RESET "\n", test_name, (long)result);
   } else {
-    printf(COLOR_RED "✗ %s: expected %ld, got %ld" COLOR_RESET "\n", test_name,
+    failures++;
+    REPORT(COLOR_RED "✗ %s: expected %ld, got %ld" COLOR_RESET "\n", test_name,
            (long)expected, (long)result);
   }
 }
@@ -29,10 +64,11 @@ static void verify_int32(const char *test_name, int32_t result,
 static void verify_int64(const char *test_name, int64_t result,
                          int64_t expected) {
   if (result == expected) {
-    printf(COLOR_GREEN "✓ %s: 0x%llx" COLOR_RESET "\n", test_name,
+    REPORT(COLOR_GREEN "✓ %s: 0x%llx" COLOR_RESET "\n", test_name,
            (unsigned long long)result);
   } else {
-    printf(COLOR_RED "✗ %s: expected 0x%llx, got 0x%llx" COLOR_RESET "\n",
+    failures++;
+    REPORT(COLOR_RED "✗ %s: expected 0x%llx, got 0x%llx" COLOR_RESET "\n",
            test_name, (unsigned long long)expected, (unsigned long long)result);
   }
 }
@@ -41,9 +77,10 @@ static void verify_float(const char *test_name, float result, float expected) {
   // Use small epsilon for floating point comparison
   float epsilon = 0.0001f;
   if (result >= expected - epsilon && result <= expected + epsilon) {
-    printf(COLOR_GREEN "✓ %s: %f" COLOR_RESET "\n", test_name, result);
+    REPORT(COLOR_GREEN "✓ %s: %f" COLOR_RESET "\n", test_name, result);
   } else {
-    printf(COLOR_RED "✗ %s: expected %f, got %f" COLOR_RESET "\n", test_name,
+    failures++;
+    REPORT(COLOR_RED "✗ %s: expected %f, got %f" COLOR_RESET "\n", test_name,
            expected, result);
   }
 }
@@ -53,31 +90,186 @@ static void verify_double(const char *test_name, double result,
   // Use small epsilon for floating point comparison
   double epsilon = 0.0001;
   if (result >= expected - epsilon && result <= expected + epsilon) {
-    printf(COLOR_GREEN "✓ %s: %f" COLOR_RESET "\n", test_name, result);
+    REPORT(COLOR_GREEN "✓ %s: %f" COLOR_RESET "\n", test_name, result);
   } else {
-    printf(COLOR_RED "✗ %s: expected %f, got %f" COLOR_RESET "\n", test_name,
+    failures++;
+    REPORT(COLOR_RED "✗ %s: expected %f, got %f" COLOR_RESET "\n", test_name,
            expected, result);
   }
 }
 
 static int32_t helper_add(int32_t a, int32_t b) { return a + b; }
 
+#if UC_HAS_CLOSURES
+/**
+ * Closure handlers: add two ints / sum every argument as a long long
+ */
+static void closure_add_handler(void *user, const arg_t *args,
+                                return_value_t *ret) {
+  (void)user;
+  ret->i = args[0].value.i + args[1].value.i;
+}
+
+static void closure_sum_handler(void *user, const arg_t *args,
+                                return_value_t *ret) {
+  const arg_type_t *types = user;
+  long long sum = 0;
+  for (int i = 0; i < 12; i++) {
+    switch (types[i]) {
+    case ARG_CHAR:
+    case ARG_SHORT:
+    case ARG_INT:
+      sum += args[i].value.i;
+      break;
+    case ARG_LONG_LONG:
+      sum += args[i].value.ll;
+      break;
+    case ARG_FLOAT:
+      sum += args[i].value.f;
+      break;
+    case ARG_DOUBLE:
+      sum += args[i].value.d;
+      break;
+    case ARG_POINTER:
+      sum += (intptr_t)args[i].value.p;
+      break;
+    default:
+      break;
+    }
+  }
+  ret->ll = sum;
+}
+#endif
+
+#if UC_HAS_LOADER
+// modules/example.c 的可重定位目标文件 (module_blobs.S)
+extern const char module_example[], module_example_end[];
+
+/**
+ * Look up a module export and prepare a descriptor for it
+ */
+static int bind_module_export(const loader_module_t *module, const char *name,
+                              func_t *func, arg_t *args,
+                              uint32_t arg_capacity) {
+  const loader_export_t *export = loader_find(module, name);
+  if (export == NULL) {
+    failures++;
+    REPORT(COLOR_RED "✗ %s: not exported" COLOR_RESET "\n", name);
+    return 0;
+  }
+  if (loader_bind(export, func, args, arg_capacity) != LOADER_OK) {
+    failures++;
+    REPORT(COLOR_RED "✗ %s: too many arguments" COLOR_RESET "\n", name);
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * Load a copy of the example module with one XLEN field overwritten
+ */
+static loader_status_t load_patched_module(size_t offset, uxlen_t value) {
+  size_t size = module_example_end - module_example;
+  uint8_t *copy = malloc(size);
+  if (copy == NULL) {
+    return LOADER_ERR_NO_MEMORY;
+  }
+  memcpy(copy, module_example, size);
+  memcpy(copy + offset, &value, sizeof(value));
+  loader_module_t *module;
+  loader_status_t status = loader_load(copy, size, &module);
+  if (status == LOADER_OK) {
+    loader_unload(module);
+  }
+  free(copy);
+  return status;
+}
+#endif
+
+#ifdef USE_RPC
+/**
+ * Payload function for the end-to-end benchmark: FNV-1a over the buffer
+ */
+static uint32_t bench_checksum(const uint8_t *data, int32_t len) {
+  uint32_t hash = 0x811C9DC5u;
+  for (int32_t i = 0; i < len; i++) {
+    hash = (hash ^ data[i]) * 0x01000193u;
+  }
+  return hash;
+}
+
+#define RPC_INTS(n) (const arg_type_t[n]){[0 ... n - 1] = ARG_INT}
+
+// 可经串口调用的函数，序号即表中位置 (tools/uc_bench.py 通过 LIST 获取)
+static const loader_export_t rpc_table[] = {
+    {"test_no_args", test_no_args, RET_INT, 0, NULL},
+    {"test_reg_args", test_reg_args, RET_INT, 8, RPC_INTS(8)},
+    {"test_stack_args", test_stack_args, RET_INT, 10, RPC_INTS(10)},
+    {"test_many_args", test_many_args, RET_INT, 20, RPC_INTS(20)},
+    {"test_float_args", test_float_args, RET_DOUBLE, 4,
+     (const arg_type_t[]){ARG_FLOAT, ARG_FLOAT, ARG_DOUBLE, ARG_DOUBLE}},
+    {"test_many_doubles", test_many_doubles, RET_DOUBLE, 6,
+     (const arg_type_t[6]){[0 ... 5] = ARG_DOUBLE}},
+    {"test_long_args", test_long_args, RET_LONG, 2,
+     (const arg_type_t[]){ARG_LONG, ARG_LONG}},
+    {"bench_checksum", bench_checksum, RET_INT, 2,
+     (const arg_type_t[]){ARG_POINTER, ARG_INT}},
+};
+#endif
+
+#if UC_HAS_VECTOR
+/**
+ * Timer handler that overwrites every vector register, vl and vtype, like an
+ * auto-vectorised handler would
+ */
+static void vector_timer_expired(timer_client_t *client, trap_frame_t *frame) {
+  (void)client;
+  (void)frame;
+  asm volatile("vsetvli t0, zero, e8, m8, ta, ma\n"
+               "vmv.v.i v0, -1\n"
+               "vmv.v.i v8, -1\n"
+               "vmv.v.i v16, -1\n"
+               "vmv.v.i v24, -1\n"
+               "vsetivli zero, 1, e64, m1, ta, ma"
+               :
+               :
+               : "t0", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8",
+                 "v9", "v10", "v11", "v12", "v13", "v14", "v15", "v16", "v17",
+                 "v18", "v19", "v20", "v21", "v22", "v23", "v24", "v25", "v26",
+                 "v27", "v28", "v29", "v30", "v31", "vl", "vtype");
+  test_vector_ticks = 1;
+}
+#endif
+
 // Main function to test all cases
-void main(void) {
-  printf("=== Testing rv32_universal_caller ===\n\n");
+int main(void) {
+#if UC_HAS_BOOT_STAMPS
+  // 启动完成，可以接受调用
+  boot_mark_ready();
+  boot_report();
+#endif
+#ifdef USE_RPC
+  // 串口调用服务模式: 不运行测试，由主机端驱动 (make RPC=1 bench-e2e)
+  rpc_serve(rpc_table, sizeof(rpc_table) / sizeof(rpc_table[0]));
+  return 0;
+#endif
+#ifdef USE_PROFILER
+  profiler_start(PROFILER_INTERVAL, PROFILER_MAX_DEPTH);
+#endif
+  REPORT("=== Testing rv32_universal_caller ===\n\n");
 
   func_t func;
   return_value_t result;
 
   // Test 1: No arguments
-  printf("Test 1: No arguments\n");
+  REPORT("Test 1: No arguments\n");
   func = (func_t){
       .func = test_no_args, .ret_type = RET_INT, .arg_count = 0, .args = NULL};
   result = universal_caller(&func);
   verify_int32("test_no_args", result.i, 42);
 
   // Test 2: Various return types
-  printf("\nTest 2: Various return types\n");
+  REPORT("\nTest 2: Various return types\n");
 
   // Int32 return
   func = (func_t){.func = test_return_int32,
@@ -117,10 +309,10 @@ void main(void) {
                   .arg_count = 0,
                   .args = NULL};
   universal_caller(&func);
-  printf(COLOR_GREEN "✓ test_return_void called successfully" COLOR_RESET "\n");
+  REPORT(COLOR_GREEN "✓ test_return_void called successfully" COLOR_RESET "\n");
 
   // Test 3: Register arguments (8 arguments)
-  printf("\nTest 3: Register arguments (8 arguments)\n");
+  REPORT("\nTest 3: Register arguments (8 arguments)\n");
   func = (func_t){.func = test_reg_args,
                   .ret_type = RET_INT,
                   .arg_count = 8,
@@ -136,7 +328,7 @@ void main(void) {
   verify_int32("test_reg_args", result.i, 36); // 1+2+3+4+5+6+7+8 = 36
 
   // Test 4: Stack arguments (>8 arguments)
-  printf("\nTest 4: Stack arguments (>8 arguments)\n");
+  REPORT("\nTest 4: Stack arguments (>8 arguments)\n");
   func = (func_t){.func = test_stack_args,
                   .ret_type = RET_INT,
                   .arg_count = 10,
@@ -154,7 +346,7 @@ void main(void) {
   verify_int32("test_stack_args", result.i, 55); // 1+2+3+...+10 = 55
 
   // Test 5: Mixed argument types
-  printf("\nTest 5: Mixed argument types\n");
+  REPORT("\nTest 5: Mixed argument types\n");
   func = (func_t){.func = test_mixed_types,
                   .ret_type = RET_DOUBLE,
                   .arg_count = 7,
@@ -173,7 +365,7 @@ void main(void) {
                     -5.5f + 6.6 + (intptr_t)(void *)7);
 
   // Test 6: Floating point arguments
-  printf("\nTest 6: Floating point arguments\n");
+  REPORT("\nTest 6: Floating point arguments\n");
   func = (func_t){.func = test_float_args,
                   .ret_type = RET_DOUBLE,
                   .arg_count = 4,
@@ -185,7 +377,7 @@ void main(void) {
   verify_double("test_float_args", result.d, 11.0);
 
   // Test 7: Many arguments
-  printf("\nTest 7: Many arguments (20 args)\n");
+  REPORT("\nTest 7: Many arguments (20 args)\n");
   func = (func_t){
       .func = test_many_args,
       .ret_type = RET_INT,
@@ -202,7 +394,7 @@ void main(void) {
   verify_int32("test_many_args", result.i, 210); // Sum of 1 to 20 = 210
 
   // Test 8: Boundary values
-  printf("\nTest 8: Boundary values\n");
+  REPORT("\nTest 8: Boundary values\n");
   func = (func_t){.func = test_boundary_values,
                   .ret_type = RET_INT,
                   .arg_count = 3,
@@ -215,7 +407,7 @@ void main(void) {
                INT32_MIN + INT32_MAX + (int32_t)0x1234567887654321LL);
 
   // Test 9: Function pointer
-  printf("\nTest 9: Function pointer\n");
+  REPORT("\nTest 9: Function pointer\n");
   func = (func_t){.func = test_function_pointer,
                   .ret_type = RET_INT,
                   .arg_count = 3,
@@ -226,7 +418,7 @@ void main(void) {
   verify_int32("test_function_pointer", result.i, 579); // 123 + 456 = 579
 
   // Test 10: Recursive function test
-  printf("\nTest 10: Recursive function test\n");
+  REPORT("\nTest 10: Recursive function test\n");
   func = (func_t){.func = test_recursive,
                   .ret_type = RET_INT,
                   .arg_count = 1,
@@ -236,7 +428,7 @@ void main(void) {
   verify_int32("test_recursive", result.i, 15);
 
   // Test 11: Many doubles test
-  printf("\nTest 11: Many doubles test\n");
+  REPORT("\nTest 11: Many doubles test\n");
   func = (func_t){.func = test_many_doubles,
                   .ret_type = RET_DOUBLE,
                   .arg_count = 6,
@@ -251,7 +443,7 @@ void main(void) {
                 23.1); // 1.1 + 2.2 + 3.3 + 4.4 + 5.5 + 6.6 = 23.1
 
   // Test 12: Stack alignment test
-  printf("\nTest 12: Stack alignment test\n");
+  REPORT("\nTest 12: Stack alignment test\n");
   func = (func_t){.func = test_stack_alignment,
                   .ret_type = RET_LONG_LONG,
                   .arg_count = 8,
@@ -268,7 +460,7 @@ void main(void) {
                36); // 1 + 2 + 3 + 4 + 5 + 6 + 7 + 8 = 36
 
   // Test 13: Variadic function test
-  printf("\nTest 13: Variadic function test\n");
+  REPORT("\nTest 13: Variadic function test\n");
   func = (func_t){.func = test_variadic,
                   .ret_type = RET_INT,
                   .arg_count = 6,
@@ -284,7 +476,7 @@ void main(void) {
   verify_int32("test_variadic", result.i, 150); // 10 + 20 + 30 + 40 + 50 = 150
 
   // Test 14: Complex stack parameters test
-  printf("\nTest 14: Complex stack parameters test\n");
+  REPORT("\nTest 14: Complex stack parameters test\n");
   func = (func_t){.func = test_complex_stack_params,
                   .ret_type = RET_LONG_LONG,
                   .arg_count = 12,
@@ -307,7 +499,7 @@ void main(void) {
                78); // 1+2+3+4+5+6+7+8+9+10+11+12=78
 
   // Test 15: Unsigned types test
-  printf("\nTest 15: Unsigned types test\n");
+  REPORT("\nTest 15: Unsigned types test\n");
   func = (func_t){.func = test_unsigned_types,
                   .ret_type = RET_LONG_LONG,
                   .arg_count = 4,
@@ -323,7 +515,7 @@ void main(void) {
                0xFF + 0xFFFF + 0xFFFFFFFF + 0xFFFFFFFFFFFFFFFFULL);
 
   // Test 16: Many floats test
-  printf("\nTest 16: Many floats test\n");
+  REPORT("\nTest 16: Many floats test\n");
   func = (func_t){.func = test_many_floats,
                   .ret_type = RET_FLOAT,
                   .arg_count = 10,
@@ -341,7 +533,7 @@ void main(void) {
   verify_float("test_many_floats", result.f, 55.0f); // 1+2+3+4+5+6+7+8+9+10=55
 
   // Test 17: Mixed many arguments test
-  printf("\nTest 17: Mixed many arguments test\n");
+  REPORT("\nTest 17: Mixed many arguments test\n");
   func = (func_t){.func = test_mixed_many_args,
                   .ret_type = RET_DOUBLE,
                   .arg_count = 16,
@@ -366,7 +558,7 @@ void main(void) {
                 136.0); // 1+2+3+4+5+6+7+8+9+10+11+12+13+14+15+16=136
 
   // Test 18: Float extremes test
-  printf("\nTest 18: Float extremes test\n");
+  REPORT("\nTest 18: Float extremes test\n");
   // Prepare special floating point values
   float float_zero = 0.0f;
   float float_inf = __builtin_inff(); // Use compiler builtin for infinity
@@ -388,7 +580,7 @@ void main(void) {
   verify_double("test_float_extremes", result.d, double_min + double_max);
 
   // Test 19: Bit operations test
-  printf("\nTest 19: Bit operations test\n");
+  REPORT("\nTest 19: Bit operations test\n");
   int8_t bit_op_a1 = 0xA5;
   uint16_t bit_op_a2 = 0xCDEF;
   int32_t bit_op_a3 = 0x12345678;
@@ -409,7 +601,7 @@ void main(void) {
   verify_int64("test_bit_operations", result.ll, expected_bit_result);
 
   // Test 20: Float register and stack test
-  printf("\nTest 20: Float register and stack test\n");
+  REPORT("\nTest 20: Float register and stack test\n");
   func = (func_t){.func = test_float_reg_and_stack,
                   .ret_type = RET_DOUBLE,
                   .arg_count = 12,
@@ -429,5 +621,506 @@ void main(void) {
   verify_double("test_float_reg_and_stack", result.d,
                 78.0); // 1+2+3+4+5+6+7+8+9+10+11+12=78
 
-  printf("\n=== All tests completed ===\n");
+  // Test 21: Long arguments (XLEN-wide)
+  REPORT("\nTest 21: Long arguments\n");
+  func = (func_t){.func = test_long_args,
+                  .ret_type = RET_LONG,
+                  .arg_count = 2,
+                  .args = (arg_t[]){{ARG_LONG, {.l = LONG_MAX}},
+                                    {ARG_LONG, {.l = 1}}}};
+  result = universal_caller(&func);
+  verify_int64("test_long_args", result.l, LONG_MAX - 1);
+
+#if UC_HAS_INT128
+  // Test 22: __int128 arguments (rv64 2*XLEN)
+  REPORT("\nTest 22: __int128 arguments\n");
+  __int128 int128_value = ((__int128)0x0123456789ABCDEFLL << 64) | 0xFEDCBA98;
+  func = (func_t){.func = test_int128,
+                  .ret_type = RET_INT128,
+                  .arg_count = 2,
+                  .args = (arg_t[]){{ARG_INT, {.i = 7}},
+                                    {ARG_INT128, {.i128 = int128_value}}}};
+  result = universal_caller(&func);
+  verify_int64("test_int128 (hi)", (int64_t)(result.i128 >> 64),
+               (int64_t)((int128_value + 7) >> 64));
+  verify_int64("test_int128 (lo)", (int64_t)result.i128,
+               (int64_t)(int128_value + 7));
+
+  // Test 23: __int128 split between a7 and the stack
+  REPORT("\nTest 23: __int128 split between a7 and the stack\n");
+  func = (func_t){.func = test_int128_split,
+                  .ret_type = RET_INT128,
+                  .arg_count = 9,
+                  .args = (arg_t[]){{ARG_INT, {.i = 1}},
+                                    {ARG_INT, {.i = 2}},
+                                    {ARG_INT, {.i = 3}},
+                                    {ARG_INT, {.i = 4}},
+                                    {ARG_INT, {.i = 5}},
+                                    {ARG_INT, {.i = 6}},
+                                    {ARG_INT, {.i = 7}},
+                                    {ARG_INT128, {.i128 = int128_value}},
+                                    {ARG_INT, {.i = 8}}}};
+  result = universal_caller(&func);
+  verify_int64("test_int128_split (hi)", (int64_t)(result.i128 >> 64),
+               (int64_t)((int128_value + 36) >> 64));
+  verify_int64("test_int128_split (lo)", (int64_t)result.i128,
+               (int64_t)(int128_value + 36));
+#endif
+
+#if UC_HAS_CLOSURES
+  // Test 24: Closure as a native callback
+  REPORT("\nTest 24: Closure as a native callback\n");
+  void *closure_add = closure_create(
+      RET_INT, (arg_type_t[]){ARG_INT, ARG_INT}, 2, closure_add_handler, NULL);
+  func = (func_t){.func = test_function_pointer,
+                  .ret_type = RET_INT,
+                  .arg_count = 3,
+                  .args = (arg_t[]){{ARG_POINTER, {.p = closure_add}},
+                                    {ARG_INT, {.i = 123}},
+                                    {ARG_INT, {.i = 456}}}};
+  result = universal_caller(&func);
+  verify_int32("closure_add", result.i, 579);
+  closure_destroy(closure_add);
+
+  // Test 25: Closure decoding registers and stack (Test 14 signature)
+  REPORT("\nTest 25: Closure decoding registers and stack\n");
+  static const arg_type_t closure_sum_types[12] = {
+      ARG_CHAR,    ARG_SHORT, ARG_INT, ARG_LONG_LONG, ARG_FLOAT,     ARG_DOUBLE,
+      ARG_POINTER, ARG_CHAR,  ARG_INT, ARG_LONG_LONG, ARG_FLOAT, ARG_DOUBLE};
+  void *closure_sum =
+      closure_create(RET_LONG_LONG, closure_sum_types, 12, closure_sum_handler,
+                     (void *)closure_sum_types);
+  func = (func_t){.func = closure_sum,
+                  .ret_type = RET_LONG_LONG,
+                  .arg_count = 12,
+                  .args = (arg_t[]){{ARG_CHAR, {.c = 1}},
+                                    {ARG_SHORT, {.s = 2}},
+                                    {ARG_INT, {.i = 3}},
+                                    {ARG_LONG_LONG, {.ll = 4LL}},
+                                    {ARG_FLOAT, {.f = 5.0f}},
+                                    {ARG_DOUBLE, {.d = 6.0}},
+                                    {ARG_POINTER, {.p = (void *)7}},
+                                    {ARG_CHAR, {.c = 8}},
+                                    {ARG_INT, {.i = 9}},
+                                    {ARG_LONG_LONG, {.ll = 10LL}},
+                                    {ARG_FLOAT, {.f = 11.0f}},
+                                    {ARG_DOUBLE, {.d = 12.0}}}};
+  result = universal_caller(&func);
+  verify_int64("closure_sum", result.ll, 78);
+  closure_destroy(closure_sum);
+
+  // 不支持的签名在占用槽位之前被拒绝
+  void *closure_bad_arg = closure_create(
+      RET_INT, (arg_type_t[]){ARG_INT, ARG_VECTOR}, 2, closure_add_handler,
+      NULL);
+  verify_int32("closure_create (ARG_VECTOR)", closure_bad_arg == NULL, 1);
+  void *closure_bad_ret = closure_create(
+      RET_VECTOR, (arg_type_t[]){ARG_INT, ARG_INT}, 2, closure_add_handler,
+      NULL);
+  verify_int32("closure_create (RET_VECTOR)", closure_bad_ret == NULL, 1);
+  void *closure_pool_fill[CLOSURE_POOL_SIZE];
+  int32_t closure_pool_free = 0;
+  for (int32_t i = 0; i < CLOSURE_POOL_SIZE; i++) {
+    closure_pool_fill[i] = closure_create(
+        RET_INT, (arg_type_t[]){ARG_INT, ARG_INT}, 2, closure_add_handler,
+        NULL);
+    closure_pool_free += closure_pool_fill[i] != NULL;
+  }
+  verify_int32("closure pool slots after rejects", closure_pool_free,
+               CLOSURE_POOL_SIZE);
+  verify_int32("closure_create (pool exhausted)",
+               closure_create(RET_INT, (arg_type_t[]){ARG_INT, ARG_INT}, 2,
+                              closure_add_handler, NULL) == NULL,
+               1);
+  for (int32_t i = 0; i < CLOSURE_POOL_SIZE; i++) {
+    closure_destroy(closure_pool_fill[i]);
+  }
+#endif
+
+  // Test 26: Memoisation of a pure function
+  REPORT("\nTest 26: Memoisation of a pure function\n");
+  memo_reset_stats();
+  func = (func_t){.func = test_memo_scale,
+                  .ret_type = RET_FLOAT,
+                  .arg_count = 2,
+                  .args = (arg_t[]){{ARG_FLOAT, {.f = 2.5f}},
+                                    {ARG_INT, {.i = 4}}},
+                  .flags = FUNC_FLAG_PURE};
+  result = memo_call(&func);
+  verify_float("memo_call (miss)", result.f, 10.0f);
+  result = memo_call(&func);
+  verify_float("memo_call (hit)", result.f, 10.0f);
+  verify_int32("memo real calls after hit", test_memo_calls, 1);
+
+  // -0.0f 与 0.0f 比较相等，但位模式不同，必须是两个键 (按位检查符号，不受 -Ofast 影响)
+  func.args[0].value.f = -0.0f;
+  result = memo_call(&func);
+  verify_int32("memo -0.0f sign", result._raw32[0] >> 31, 1);
+  func.args[0].value.f = 0.0f;
+  result = memo_call(&func);
+  verify_int32("memo 0.0f sign", result._raw32[0] >> 31, 0);
+  verify_int32("memo real calls for +-0.0f", test_memo_calls, 3);
+
+  // 失效后重新调用；未标记 PURE 的描述符始终直接调用
+  memo_invalidate(test_memo_scale);
+  func.args[0].value.f = 2.5f;
+  result = memo_call(&func);
+  verify_float("memo_call (after invalidate)", result.f, 10.0f);
+  func.flags = 0;
+  result = memo_call(&func);
+  verify_float("memo_call (not pure)", result.f, 10.0f);
+  verify_int32("memo real calls total", test_memo_calls, 5);
+
+  memo_stats_t memo_stats;
+  memo_get_stats(&memo_stats);
+  verify_int32("memo hits", memo_stats.hits, 1);
+  verify_int32("memo misses", memo_stats.misses, 4);
+  verify_int32("memo bypasses", memo_stats.bypasses, 1);
+  verify_int32("memo invalidations", memo_stats.invalidations, 3);
+  memo_invalidate_all();
+
+#if UC_HAS_LOADER
+  // Test 27: Runtime-loaded module
+  REPORT("\nTest 27: Runtime-loaded module\n");
+  verify_int32("loader_load (not ELF)",
+               loader_load("not an ELF object", 18, &(loader_module_t *){0}),
+               LOADER_ERR_FORMAT);
+  verify_int32("loader_load (truncated)",
+               loader_load(module_example,
+                           module_example_end - module_example - 1,
+                           &(loader_module_t *){0}),
+               LOADER_ERR_FORMAT);
+  {
+    // ELF 头: e_shoff 位于 0x18 + 2*XLEN，e_shstrndx 位于 0x26 + 3*XLEN；
+    // 节头: sh_offset 位于 8 + 2*XLEN，sh_size 位于 8 + 3*XLEN
+    uxlen_t shoff, shstr_size;
+    uint16_t shstrndx;
+    memcpy(&shoff, module_example + 0x18 + 2 * XLEN, sizeof(shoff));
+    memcpy(&shstrndx, module_example + 0x26 + 3 * XLEN, sizeof(shstrndx));
+    size_t shstr_hdr = shoff + shstrndx * (16 + 6 * XLEN); // sizeof(节头)
+    memcpy(&shstr_size, module_example + shstr_hdr + 8 + 3 * XLEN,
+           sizeof(shstr_size));
+    verify_int32("loader_load (e_shoff wraps)",
+                 load_patched_module(0x18 + 2 * XLEN, ~(uxlen_t)0xF),
+                 LOADER_ERR_FORMAT);
+    verify_int32("loader_load (sh_offset wraps)",
+                 load_patched_module(shstr_hdr + 8 + 2 * XLEN, ~(uxlen_t)0),
+                 LOADER_ERR_FORMAT);
+    // 去掉结尾的 NUL: 字符串表不再以 NUL 结尾
+    verify_int32("loader_load (unterminated strtab)",
+                 load_patched_module(shstr_hdr + 8 + 3 * XLEN, shstr_size - 1),
+                 LOADER_ERR_FORMAT);
+  }
+  for (int round = 0; round < 2; round++) { // 第二轮验证卸载后内存可复用
+    loader_module_t *module;
+    loader_status_t status = loader_load(
+        module_example, module_example_end - module_example, &module);
+    verify_int32("loader_load", status, LOADER_OK);
+    if (status != LOADER_OK) {
+      break;
+    }
+    arg_t module_args[4];
+    const uint32_t module_arg_capacity =
+        sizeof(module_args) / sizeof(module_args[0]);
+    if (bind_module_export(module, "module_scaled_sum", &func, module_args,
+                           module_arg_capacity)) {
+      module_args[0].value.i = 4;
+      module_args[1].value.i = 10;
+      result = universal_caller(&func);
+      verify_int32("module_scaled_sum", result.i, 42); // (4 + 10) * 3
+      // func 沿用自 Test 26 (FUNC_FLAG_PURE)，绑定后其余字段应清零
+      verify_int32("loader_bind clears flags", func.flags, 0);
+      func.flags = FUNC_FLAG_PURE;
+      result = memo_call(&func);
+      verify_int32("module_scaled_sum (memo_call)", result.i, 42);
+    }
+    if (bind_module_export(module, "module_dot2", &func, module_args,
+                           module_arg_capacity)) {
+      module_args[0].value.d = 1.5;
+      module_args[1].value.d = 2.0;
+      module_args[2].value.d = 4.0;
+      module_args[3].value.d = -0.5;
+      result = universal_caller(&func);
+      verify_double("module_dot2", result.d, 5.0);
+    }
+    if (bind_module_export(module, "module_string_length", &func,
+                           module_args, module_arg_capacity)) {
+      module_args[0].value.p = "universal caller";
+      result = universal_caller(&func);
+      verify_int32("module_string_length (imports strlen)", result.i, 16);
+    }
+    if (bind_module_export(module, "module_call_count", &func, module_args,
+                           module_arg_capacity)) {
+      result = universal_caller(&func);
+      verify_int32("module_call_count (.bss)", result.i, 3);
+    }
+    const loader_export_t *dot2 = loader_find(module, "module_dot2");
+    if (dot2 != NULL) {
+      verify_int32("loader_bind (4 arguments, capacity 1)",
+                   loader_bind(dot2, &func, module_args, 1), LOADER_ERR_ARGS);
+    }
+    memo_stats_t before, after;
+    memo_get_stats(&before);
+    loader_unload(module);
+    memo_get_stats(&after);
+    verify_int32("loader_unload drops memo entries",
+                 after.invalidations - before.invalidations, 1);
+  }
+#endif
+
+  // Test 28: Call-chain program (loop, result forwarding, branch)
+  REPORT("\nTest 28: Call-chain program\n");
+  func_t chain_add = {.func = helper_add,
+                      .ret_type = RET_INT,
+                      .arg_count = 2,
+                      .args = (arg_t[]){{ARG_INT, {.i = 0}}, {ARG_INT, {.i = 0}}}};
+  func_t chain_sub = {.func = test_long_args,
+                      .ret_type = RET_LONG,
+                      .arg_count = 2,
+                      .args = (arg_t[]){{ARG_LONG, {.l = 0}}, {ARG_LONG, {.l = 0}}}};
+  // s0 = sum(1..10) (循环调用 helper_add)，r1 = s0 - 13，r1 非零时输出 r1 与 s0
+  const chain_insn_t chain_insns[] = {
+      /* 0 */ {.op = CHAIN_OP_SET, .dst = 0, .a = CHAIN_CONST_INT(0)},
+      /* 1 */ {.op = CHAIN_OP_SET, .dst = 1, .a = CHAIN_CONST_INT(1)},
+      /* 2 */
+      {.op = CHAIN_OP_CALL,
+       .dst = 0,
+       .func = &chain_add,
+       .operands = (chain_operand_t[]){CHAIN_SCRATCH(0), CHAIN_SCRATCH(1)}},
+      /* 3 */ {.op = CHAIN_OP_SET, .dst = 0, .a = CHAIN_RESULT(0)},
+      /* 4 */
+      {.op = CHAIN_OP_ADD,
+       .dst = 1,
+       .a = CHAIN_SCRATCH(1),
+       .b = CHAIN_CONST_INT(1)},
+      /* 5 */
+      {.op = CHAIN_OP_JLT,
+       .target = 2,
+       .a = CHAIN_SCRATCH(1),
+       .b = CHAIN_CONST_INT(11)},
+      /* 6 */
+      {.op = CHAIN_OP_CALL,
+       .dst = 1,
+       .func = &chain_sub,
+       .operands = (chain_operand_t[]){CHAIN_RESULT(0), CHAIN_CONST_INT(13)}},
+      /* 7 */ {.op = CHAIN_OP_JNZ, .target = 9, .a = CHAIN_RESULT(1)},
+      /* 8 */ {.op = CHAIN_OP_EMIT, .a = CHAIN_CONST_INT(-1)},
+      /* 9 */ {.op = CHAIN_OP_EMIT, .a = CHAIN_RESULT(1)},
+      /* 10 */ {.op = CHAIN_OP_EMIT, .a = CHAIN_SCRATCH(0)},
+      /* 11 */ {.op = CHAIN_OP_HALT},
+  };
+  chain_state_t chain_state = {0};
+  chain_status_t chain_status = chain_run(
+      &(chain_program_t){.insns = chain_insns,
+                         .insn_count = sizeof(chain_insns) / sizeof(chain_insns[0])},
+      &chain_state);
+  verify_int32("chain_run", chain_status, CHAIN_OK);
+  verify_int32("chain calls", chain_state.calls, 11);
+  verify_int32("chain output count", chain_state.output_count, 2);
+  verify_int64("chain output[0]", chain_value_int(&chain_state.output[0]), 42);
+  verify_int64("chain output[1]", chain_value_int(&chain_state.output[1]), 55);
+
+  // 死循环由步数上限终止
+  const chain_insn_t chain_spin[] = {{.op = CHAIN_OP_JMP, .target = 0}};
+  chain_status = chain_run(
+      &(chain_program_t){.insns = chain_spin, .insn_count = 1, .max_steps = 100},
+      &chain_state);
+  verify_int32("chain step limit", chain_status, CHAIN_ERR_STEP_LIMIT);
+
+#ifdef USE_SEMIHOSTING
+  // Test 29: Host file I/O through semihosting
+  REPORT("\nTest 29: Host file I/O through semihosting\n");
+  static uint32_t sh_out[1024], sh_in[1024];
+  for (uint32_t i = 0; i < 1024; i++) {
+    sh_out[i] = i * 2654435761u;
+  }
+  FILE *sh_file = fopen("semihost_test.bin", "w+b");
+  verify_int32("semihost fopen", sh_file != NULL, 1);
+  if (sh_file != NULL) {
+    verify_int32("semihost fwrite", fwrite(sh_out, 4, 1024, sh_file), 1024);
+    verify_int32("semihost ftell", ftell(sh_file), 4096);
+    fseek(sh_file, 0, SEEK_SET);
+    verify_int32("semihost fread", fread(sh_in, 4, 1024, sh_file), 1024);
+    verify_int32("semihost data", memcmp(sh_in, sh_out, sizeof(sh_out)), 0);
+    fseek(sh_file, -8, SEEK_END);
+    verify_int32("semihost SEEK_END", fread(sh_in, 4, 1, sh_file), 1);
+    verify_int64("semihost SEEK_END data", sh_in[0], sh_out[1022]);
+    fclose(sh_file);
+    verify_int32("semihost unlink", unlink("semihost_test.bin"), 0);
+  }
+#endif
+
+#if UC_HAS_VECTOR
+  // Test 30: RVV vector arguments (register groups, mask, by reference)
+  REPORT("\nTest 30: RVV vector arguments\n");
+  int32_t vec_a[8], vec_b[8], vec_sum[8];
+  for (int32_t i = 0; i < 8; i++) {
+    vec_a[i] = i * 100;
+    vec_b[i] = i - 4;
+  }
+  vector_arg_t vec_ret = {.data = vec_sum, .vl = 8, .sew = 32, .lmul = 2};
+  func = (func_t){
+      .func = test_vector_add,
+      .ret_type = RET_VECTOR,
+      .arg_count = 4,
+      .args = (arg_t[]){
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_a, 8, 32, 2}}},
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_b, 8, 32, 2}}},
+          {ARG_INT, {.i = 3}},
+          {ARG_LONG, {.l = 8}}},
+      .ret_vector = &vec_ret};
+  result = universal_caller(&func);
+  verify_int32("test_vector_add (pointer)", result.p == vec_sum, 1);
+  verify_int32("test_vector_add [0]", vec_sum[0], -12);
+  verify_int32("test_vector_add [7]", vec_sum[7], 709);
+
+  int16_t vec_x[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  int16_t vec_y[8] = {10, 20, 30, 40, 50, 60, 70, 80};
+  int16_t vec_big[32], vec_sel[8];
+  for (int32_t i = 0; i < 32; i++) {
+    vec_big[i] = -1 - i;
+  }
+  uint8_t vec_mask = 0x5A; // 元素 1,3,4,6
+  vec_ret = (vector_arg_t){.data = vec_sel, .vl = 8, .sew = 16, .lmul = 1};
+  func = (func_t){
+      .func = test_vector_select,
+      .ret_type = RET_VECTOR,
+      .arg_count = 5,
+      .args = (arg_t[]){
+          {ARG_VECTOR_MASK, {.p = &(vector_arg_t){&vec_mask, 8, 1, 1}}},
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_x, 8, 16, 1}}},
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_big, 8, 16, 4}}},
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_y, 8, 16, 1}}},
+          {ARG_LONG, {.l = 8}}},
+      .ret_vector = &vec_ret};
+  universal_caller(&func);
+  verify_int32("test_vector_select [0]", vec_sel[0], -1);
+  verify_int32("test_vector_select [1]", vec_sel[1], 22);
+  verify_int32("test_vector_select [6]", vec_sel[6], 77);
+  verify_int32("test_vector_select [7]", vec_sel[7], -8);
+
+  uint8_t vec_less = 0;
+  vec_ret = (vector_arg_t){.data = &vec_less, .vl = 8, .sew = 1, .lmul = 1};
+  int16_t vec_pivot[8] = {5, 5, 5, 5, 5, 5, 5, 5};
+  func = (func_t){
+      .func = test_vector_less,
+      .ret_type = RET_VECTOR_MASK,
+      .arg_count = 3,
+      .args = (arg_t[]){
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_x, 8, 16, 1}}},
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_pivot, 8, 16, 1}}},
+          {ARG_LONG, {.l = 8}}},
+      .ret_vector = &vec_ret};
+  universal_caller(&func);
+  verify_int32("test_vector_less", vec_less, 0x0F);
+
+  static int32_t vec_m8[3][32];
+  for (int32_t i = 0; i < 32; i++) {
+    vec_m8[0][i] = i;
+    vec_m8[1][i] = 1000;
+    vec_m8[2][i] = -i * 2;
+  }
+  func = (func_t){
+      .func = test_vector_spill,
+      .ret_type = RET_INT,
+      .arg_count = 4,
+      .args = (arg_t[]){
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_m8[0], 32, 32, 8}}},
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_m8[1], 32, 32, 8}}},
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_m8[2], 32, 32, 8}}},
+          {ARG_LONG, {.l = 32}}}};
+  result = universal_caller(&func);
+  verify_int32("test_vector_spill", result.i, 32000 - 496);
+
+  // 计时器中断打断向量被调函数，处理程序改写全部向量状态
+  static timer_client_t vector_timer;
+  trap_init();
+  timer_register(&vector_timer, vector_timer_expired);
+  for (int32_t i = 0; i < 8; i++) {
+    vec_a[i] = i * 7;
+    vec_b[i] = 1000 - i;
+  }
+  vec_ret = (vector_arg_t){.data = vec_sum, .vl = 8, .sew = 32, .lmul = 2};
+  func = (func_t){
+      .func = test_vector_interrupted,
+      .ret_type = RET_VECTOR,
+      .arg_count = 3,
+      .args = (arg_t[]){
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_a, 8, 32, 2}}},
+          {ARG_VECTOR, {.p = &(vector_arg_t){vec_b, 8, 32, 2}}},
+          {ARG_LONG, {.l = 8}}},
+      .ret_vector = &vec_ret};
+  test_vector_ticks = 0;
+  timer_arm(&vector_timer, timer_now() + 100); // 10us 后，可能落在装载阶段
+  universal_caller(&func);
+  verify_int32("vector call interrupted", test_vector_ticks, 1);
+  verify_int32("test_vector_interrupted [0]", vec_sum[0], 1000);
+  verify_int32("test_vector_interrupted [7]", vec_sum[7], 1042);
+#endif
+
+#if UC_HAS_BUDGET
+  // Test 31: Time budget abandons a runaway callee
+  REPORT("\nTest 31: Per-call time budget\n");
+  budget_reset_stats();
+  arg_t budget_args[10];
+  for (int32_t i = 0; i < 10; i++) {
+    budget_args[i] = (arg_t){ARG_INT, {.i = i + 1}};
+  }
+  func = (func_t){.func = test_runaway,
+                  .ret_type = RET_INT,
+                  .arg_count = 10,
+                  .args = budget_args,
+                  .time_budget = 10000}; // 1ms (mtime 10MHz)
+  call_status_t call_status = universal_caller_budgeted(&func, &result);
+  verify_int32("runaway call status", call_status, CALL_TIMEOUT);
+
+  func.func = test_stack_args; // 同一栈参数布局，放弃后栈指针须已恢复
+  call_status = universal_caller_budgeted(&func, &result);
+  verify_int32("budgeted call status", call_status, CALL_OK);
+  verify_int32("budgeted call result", result.i, 55);
+
+  budget_stats_t budget;
+  budget_get_stats(&budget);
+  verify_int32("budget calls", budget.calls, 2);
+  verify_int32("budget overruns", budget.overruns, 1);
+
+  // 预算略高于被调函数的耗时: 截止时间常落在刚返回之后，
+  // 已返回的调用必须报告 CALL_OK 与结果，且不计为超时
+  uint32_t budget_runtime = (uint32_t)budget.max_ticks;
+  uint32_t sweep_ok = 0, sweep_timeouts = 0, sweep_bad = 0;
+  budget_reset_stats();
+  for (uint32_t ticks = 1; ticks <= budget_runtime + 4; ticks++) {
+    for (int32_t r = 0; r < 8; r++) {
+      func.time_budget = ticks;
+      result.i = 0;
+      call_status = universal_caller_budgeted(&func, &result);
+      if (call_status == CALL_OK) {
+        sweep_ok++;
+        sweep_bad += result.i != 55;
+      } else if (call_status == CALL_TIMEOUT) {
+        sweep_timeouts++;
+      } else {
+        sweep_bad++;
+      }
+    }
+  }
+  budget_get_stats(&budget);
+  verify_int32("budget sweep: wrong results", sweep_bad, 0);
+  verify_int32("budget sweep: calls", budget.calls, sweep_ok + sweep_timeouts);
+  verify_int32("budget sweep: overruns = timeouts", budget.overruns,
+               sweep_timeouts);
+#endif
+
+  REPORT("\n=== All tests completed ===\n");
+#ifdef USE_DLOG
+  dlog_flush();
+#endif
+#ifdef USE_PROFILER
+  profiler_stop();
+  profiler_dump();
+#endif
+#ifdef USE_CALLCOUNT
+  callcount_dump();
+#endif
+  return failures;
 }
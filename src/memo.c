@@ -0,0 +1,195 @@
+#include "memo.h"
+#include <stdbool.h>
+#include <string.h>
+
+_Static_assert((MEMO_SETS & (MEMO_SETS - 1)) == 0, "MEMO_SETS 必须为2的幂");
+
+/**
+ * 规范化后的查找键: 参数值按类型取位模式，避免 arg_value_t 中未使用字节的影响
+ */
+typedef struct {
+  void *func;
+  ret_type_t ret_type;
+  int32_t arg_count;
+  arg_type_t types[MEMO_MAX_ARGS];
+  uint64_t values[MEMO_MAX_ARGS];
+} memo_key_t;
+
+typedef struct {
+  memo_key_t key;
+  return_value_t result;
+  uint32_t hash;
+  bool valid;
+  bool referenced; // CLOCK 引用位
+} memo_entry_t;
+
+typedef struct {
+  memo_entry_t ways[MEMO_WAYS];
+  uint32_t hand; // CLOCK 指针
+} memo_set_t;
+
+static memo_set_t memo_sets[MEMO_SETS];
+static memo_stats_t memo_stats;
+
+static inline uint32_t memo_mix(uint32_t hash, uint32_t word) {
+  hash ^= word;
+  hash *= 0x9E3779B1u; // 32位黄金比例常数
+  return hash ^ (hash >> 15);
+}
+
+/**
+ * 生成规范化键与散列值
+ *
+ * @return false 表示该签名不可缓存
+ */
+static bool memo_make_key(const func_t *func, memo_key_t *key,
+                          uint32_t *hash) {
+  if (func->arg_count < 0 || func->arg_count > MEMO_MAX_ARGS) {
+    return false;
+  }
+  if (func->ret_type == RET_VECTOR || func->ret_type == RET_VECTOR_MASK) {
+    return false; // 结果写入调用方缓冲区，缓存的指针无意义
+  }
+  memset(key, 0, sizeof(*key));
+  key->func = func->func;
+  key->ret_type = func->ret_type;
+  key->arg_count = func->arg_count;
+
+  uint32_t h = memo_mix(0x811C9DC5u, (uint32_t)(uintptr_t)func->func);
+  h = memo_mix(h, ((uint32_t)func->ret_type << 8) | (uint32_t)func->arg_count);
+  for (int32_t i = 0; i < func->arg_count; i++) {
+    const arg_t *arg = &func->args[i];
+    uint64_t value;
+    switch (arg->type) {
+    case ARG_CHAR:
+    case ARG_SHORT:
+    case ARG_INT:
+    case ARG_FLOAT: // 位模式 (value.i 与 value.f 共享低32位)
+      value = (uint32_t)arg->value.i;
+      break;
+    case ARG_LONG:
+      value = (uint64_t)arg->value.l;
+      break;
+    case ARG_LONG_LONG:
+    case ARG_DOUBLE: // 位模式 (value.ll 与 value.d 共享)
+      value = (uint64_t)arg->value.ll;
+      break;
+    case ARG_POINTER:
+      value = (uintptr_t)arg->value.p;
+      break;
+    default: // ARG_INT128 等不可缓存
+      return false;
+    }
+    key->types[i] = arg->type;
+    key->values[i] = value;
+    h = memo_mix(h, arg->type);
+    h = memo_mix(h, (uint32_t)value);
+    h = memo_mix(h, (uint32_t)(value >> 32));
+  }
+  *hash = h;
+  return true;
+}
+
+static inline bool memo_key_equal(const memo_key_t *a, const memo_key_t *b) {
+  if (a->func != b->func || a->ret_type != b->ret_type ||
+      a->arg_count != b->arg_count) {
+    return false;
+  }
+  for (int32_t i = 0; i < a->arg_count; i++) {
+    if (a->types[i] != b->types[i] || a->values[i] != b->values[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// CLOCK: 优先使用空闲路，否则跳过引用位为1的路(并清除)，淘汰第一个为0的路
+static memo_entry_t *memo_victim(memo_set_t *set) {
+  for (uint32_t way = 0; way < MEMO_WAYS; way++) {
+    if (!set->ways[way].valid) {
+      return &set->ways[way];
+    }
+  }
+  while (1) {
+    memo_entry_t *entry = &set->ways[set->hand];
+    set->hand = (set->hand + 1) % MEMO_WAYS;
+    if (!entry->referenced) {
+      memo_stats.evictions++;
+      return entry;
+    }
+    entry->referenced = false;
+  }
+}
+
+return_value_t memo_call(func_t *func) {
+  memo_key_t key;
+  uint32_t hash;
+
+  if (!(func->flags & FUNC_FLAG_PURE) || !memo_make_key(func, &key, &hash)) {
+    memo_stats.bypasses++;
+    return universal_caller(func);
+  }
+
+  memo_set_t *set = &memo_sets[hash & (MEMO_SETS - 1)];
+  for (uint32_t way = 0; way < MEMO_WAYS; way++) {
+    memo_entry_t *entry = &set->ways[way];
+    if (entry->valid && entry->hash == hash &&
+        memo_key_equal(&entry->key, &key)) {
+      entry->referenced = true;
+      memo_stats.hits++;
+      return entry->result;
+    }
+  }
+
+  memo_stats.misses++;
+  return_value_t result = universal_caller(func);
+
+  memo_entry_t *entry = memo_victim(set);
+  entry->key = key;
+  entry->result = result;
+  entry->hash = hash;
+  entry->valid = true;
+  entry->referenced = false;
+  return result;
+}
+
+void memo_invalidate(void *func) {
+  for (uint32_t s = 0; s < MEMO_SETS; s++) {
+    for (uint32_t way = 0; way < MEMO_WAYS; way++) {
+      memo_entry_t *entry = &memo_sets[s].ways[way];
+      if (entry->valid && entry->key.func == func) {
+        entry->valid = false;
+        memo_stats.invalidations++;
+      }
+    }
+  }
+}
+
+void memo_invalidate_range(const void *start, size_t size) {
+  for (uint32_t s = 0; s < MEMO_SETS; s++) {
+    for (uint32_t way = 0; way < MEMO_WAYS; way++) {
+      memo_entry_t *entry = &memo_sets[s].ways[way];
+      if (entry->valid &&
+          (uintptr_t)entry->key.func - (uintptr_t)start < size) {
+        entry->valid = false;
+        memo_stats.invalidations++;
+      }
+    }
+  }
+}
+
+void memo_invalidate_all(void) {
+  for (uint32_t s = 0; s < MEMO_SETS; s++) {
+    for (uint32_t way = 0; way < MEMO_WAYS; way++) {
+      memo_entry_t *entry = &memo_sets[s].ways[way];
+      if (entry->valid) {
+        entry->valid = false;
+        memo_stats.invalidations++;
+      }
+    }
+  }
+}
+
+void memo_get_stats(memo_stats_t *stats) { *stats = memo_stats; }
+
+void memo_reset_stats(void) { memset(&memo_stats, 0, sizeof(memo_stats)); }
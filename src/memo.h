@@ -0,0 +1,69 @@
+/**
+ * memo.h - Memoisation cache for pure target functions
+ *
+ * memo_call() behaves like universal_caller(). For descriptors flagged with
+ * FUNC_FLAG_PURE, the result is looked up in a bounded set-associative cache
+ * before calling. The key is the function address, return type, argument
+ * types and argument values. Float and double values are compared bit-exactly,
+ * so -0.0 and 0.0, and NaNs with different payloads, are distinct keys.
+ * Pointer arguments are keyed by address, not by pointee. Each set is replaced
+ * with the CLOCK (second chance) policy.
+ *
+ * Descriptors with more than MEMO_MAX_ARGS arguments, or with __int128
+ * arguments, are not cached and are always called.
+ */
+
+#ifndef MEMO_H
+#define MEMO_H
+
+#include "universal_caller.h"
+
+#define MEMO_SETS 32    // 组数，必须为2的幂
+#define MEMO_WAYS 4     // 每组路数
+#define MEMO_MAX_ARGS 8 // 可缓存的最大参数数量
+
+typedef struct {
+  uint32_t hits;          // 命中
+  uint32_t misses;        // 未命中 (随后调用并插入)
+  uint32_t evictions;     // 因替换被淘汰的条目
+  uint32_t bypasses;      // 非纯函数或不可缓存的签名
+  uint32_t invalidations; // 被显式失效的条目
+} memo_stats_t;
+
+/**
+ * Call a function described by func, using the cache for pure descriptors
+ *
+ * @param func Pointer to the func_t structure containing function information
+ * @return Union containing the return value in the appropriate type field
+ */
+return_value_t memo_call(func_t *func);
+
+/**
+ * Drop all cached results of one function
+ */
+void memo_invalidate(void *func);
+
+/**
+ * Drop all cached results of functions in [start, start + size)
+ *
+ * Used when the code in that range goes away (loader_unload()), so a later
+ * function at a reused address is never answered from the old entries.
+ */
+void memo_invalidate_range(const void *start, size_t size);
+
+/**
+ * Drop all cached results
+ */
+void memo_invalidate_all(void);
+
+/**
+ * Copy the current statistics
+ */
+void memo_get_stats(memo_stats_t *stats);
+
+/**
+ * Reset the statistics counters
+ */
+void memo_reset_stats(void);
+
+#endif /* MEMO_H */
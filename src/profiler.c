@@ -0,0 +1,105 @@
+#include "profiler.h"
+#include "trap.h"
+#include <stdio.h>
+
+typedef struct {
+  uintptr_t pc[PROFILER_MAX_DEPTH];
+} profiler_sample_t;
+
+typedef struct {
+  profiler_sample_t samples[PROFILER_MAX_SAMPLES];
+  uint32_t count;
+  uint32_t dropped;
+} profiler_buffer_t;
+
+static profiler_buffer_t profiler_buffers[PROFILER_MAX_HARTS];
+static timer_client_t profiler_timer;
+static uint32_t profiler_interval;
+static uint32_t profiler_depth;
+static volatile uint32_t profiler_running;
+
+extern char _heap_end[];
+extern char _stack_top[];
+
+// 帧指针必须对齐且位于RAM内，防止沿无效的s0读取
+static inline int profiler_valid_fp(uintptr_t fp) {
+  return (fp % XLEN) == 0 && fp >= (uintptr_t)_heap_end + 2 * XLEN &&
+         fp <= (uintptr_t)_stack_top;
+}
+
+static void profiler_tick(timer_client_t *client, trap_frame_t *frame) {
+  uxlen_t hart;
+  asm volatile("csrr %0, mhartid" : "=r"(hart));
+  if (!profiler_running || hart >= PROFILER_MAX_HARTS) {
+    return;
+  }
+
+  profiler_buffer_t *buffer = &profiler_buffers[hart];
+  if (buffer->count < PROFILER_MAX_SAMPLES) {
+    profiler_sample_t *sample = &buffer->samples[buffer->count++];
+    sample->pc[0] = frame->mepc;
+
+    // RISC-V 帧布局: fp[-1] = ra, fp[-2] = 上一帧的 fp
+    uintptr_t fp = frame->x[8];
+    for (uint32_t i = 1; i < PROFILER_MAX_DEPTH; i++) {
+      if (i < profiler_depth && profiler_valid_fp(fp)) {
+        uintptr_t *slot = (uintptr_t *)fp;
+        sample->pc[i] = slot[-1];
+        uintptr_t next = slot[-2];
+        fp = next > fp ? next : 0; // 栈向下增长，上一帧地址必须更高
+      } else {
+        sample->pc[i] = 0;
+      }
+    }
+  } else {
+    buffer->dropped++;
+  }
+
+  timer_arm(client, timer_now() + profiler_interval);
+}
+
+void profiler_start(uint32_t interval, uint32_t depth) {
+  static int registered = 0;
+
+  trap_init();
+  if (!registered) {
+    timer_register(&profiler_timer, profiler_tick);
+    registered = 1;
+  }
+
+  for (uint32_t hart = 0; hart < PROFILER_MAX_HARTS; hart++) {
+    profiler_buffers[hart].count = 0;
+    profiler_buffers[hart].dropped = 0;
+  }
+  profiler_interval =
+      interval < PROFILER_MIN_INTERVAL ? PROFILER_MIN_INTERVAL : interval;
+  profiler_depth = depth < 1                    ? 1
+                   : depth > PROFILER_MAX_DEPTH ? PROFILER_MAX_DEPTH
+                                                : depth;
+  profiler_running = 1;
+  timer_arm(&profiler_timer, timer_now() + profiler_interval);
+}
+
+void profiler_stop(void) {
+  profiler_running = 0;
+  timer_disarm(&profiler_timer);
+}
+
+void profiler_dump(void) {
+  for (uint32_t hart = 0; hart < PROFILER_MAX_HARTS; hart++) {
+    profiler_buffer_t *buffer = &profiler_buffers[hart];
+    printf("PROF-BEGIN hart=%lu samples=%lu dropped=%lu interval=%lu "
+           "depth=%lu\n",
+           (unsigned long)hart, (unsigned long)buffer->count,
+           (unsigned long)buffer->dropped, (unsigned long)profiler_interval,
+           (unsigned long)profiler_depth);
+    for (uint32_t i = 0; i < buffer->count; i++) {
+      printf("PROF");
+      for (uint32_t d = 0; d < profiler_depth; d++) {
+        printf(" %lx", (unsigned long)buffer->samples[i].pc[d]);
+      }
+      printf("\n");
+    }
+    printf("PROF-END\n");
+  }
+}
@@ -0,0 +1,45 @@
+/**
+ * profiler.h - Timer-interrupt sampling profiler
+ *
+ * Every `interval` mtime ticks the machine timer interrupt records mepc and,
+ * optionally, the return-address chain into a per-hart buffer. The chain is
+ * walked through frame pointers (s0), so depth > 1 requires building with
+ * -fno-omit-frame-pointer (make PROFILE=1). Per-sample work is bounded by
+ * PROFILER_MAX_DEPTH, and recording stops when the buffer is full.
+ *
+ * profiler_dump() prints one "PROF" line per sample; tools/prof_report.py maps
+ * the addresses to symbols using the ELF.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+#define PROFILER_MAX_HARTS 1       // 每个hart一个样本缓冲区
+#define PROFILER_MAX_SAMPLES 4096  // 每个hart的样本数上限
+#define PROFILER_MAX_DEPTH 4       // 每个样本记录的地址数 (mepc + 返回地址)
+#define PROFILER_MIN_INTERVAL 100  // 最小采样间隔 (mtime ticks)，限制开销
+
+/**
+ * Start sampling
+ *
+ * @param interval Sampling period in mtime ticks (10MHz on QEMU virt)
+ * @param depth    Addresses per sample: 1 = mepc only, up to PROFILER_MAX_DEPTH
+ */
+void profiler_start(uint32_t interval, uint32_t depth);
+
+/**
+ * Stop sampling (samples are kept until the next profiler_start())
+ */
+void profiler_stop(void);
+
+/**
+ * Print all samples:
+ *   PROF-BEGIN hart=<n> samples=<n> dropped=<n> interval=<ticks> depth=<n>
+ *   PROF <pc> [<ra> ...]
+ *   PROF-END
+ */
+void profiler_dump(void);
+
+#endif /* PROFILER_H */
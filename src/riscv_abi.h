@@ -0,0 +1,70 @@
+/**
+ * riscv_abi.h - XLEN/FLEN helpers shared by C and assembly sources
+ *
+ * In C the load/store mnemonics are strings for inline asm, in assembly
+ * (__ASSEMBLER__) they are bare tokens.
+ */
+
+#ifndef RISCV_ABI_H
+#define RISCV_ABI_H
+
+#if __riscv_xlen == 32
+#define XLEN 4 // 32bits = 4 * 8b
+#ifdef __ASSEMBLER__
+#define REG_L lw
+#define REG_S sw
+#else
+#define REG_L "lw"
+#define REG_S "sw"
+#endif
+#elif __riscv_xlen == 64
+#define XLEN 8 // 64bits = 8 * 8b
+#ifdef __ASSEMBLER__
+#define REG_L ld
+#define REG_S sd
+#else
+#define REG_L "ld"
+#define REG_S "sd"
+#endif
+#else
+#error "unknown xlen"
+#endif
+
+// 浮点参数寄存器(fa0-fa7)的保存/恢复指令，仅硬浮点ABI使用
+#if __riscv_float_abi_double == 1
+#ifdef __ASSEMBLER__
+#define FREG_L fld
+#define FREG_S fsd
+#else
+#define FREG_L "fld"
+#define FREG_S "fsd"
+#endif
+#elif __riscv_float_abi_single == 1
+#ifdef __ASSEMBLER__
+#define FREG_L flw
+#define FREG_S fsw
+#else
+#define FREG_L "flw"
+#define FREG_S "fsw"
+#endif
+#endif
+
+#ifndef __ASSEMBLER__
+#include <stdint.h>
+
+#if __riscv_xlen == 32
+#define RAW_XLEN _raw32
+typedef int32_t xlen_t;
+typedef uint32_t uxlen_t;
+typedef int64_t dxlen_t; // 2*XLEN: long long (及软浮点下的double)
+typedef uint64_t udxlen_t;
+#else
+#define RAW_XLEN _raw64
+typedef int64_t xlen_t;
+typedef uint64_t uxlen_t;
+typedef __int128 dxlen_t; // 2*XLEN: __int128
+typedef unsigned __int128 udxlen_t;
+#endif
+#endif /* __ASSEMBLER__ */
+
+#endif /* RISCV_ABI_H */
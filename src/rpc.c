@@ -0,0 +1,395 @@
+#include "rpc.h"
+#include "boot.h"
+#include "chain.h"
+#include "uart.h"
+#include <stdbool.h>
+#include <string.h>
+
+// 收发缓冲区只读取已写入的部分，不需要启动时清零
+static UC_NOINIT uint8_t rpc_rx[RPC_MAX_FRAME];
+static UC_NOINIT uint8_t rpc_tx[RPC_MAX_FRAME];
+
+// RPC_OP_CHAIN 解码后的程序: 每条 CALL 一个描述符，参数模板与操作数从池中分配
+static UC_NOINIT chain_insn_t rpc_chain_insns[RPC_MAX_CHAIN_INSNS];
+static UC_NOINIT func_t rpc_chain_funcs[RPC_MAX_CHAIN_INSNS];
+static UC_NOINIT arg_t rpc_chain_args[RPC_MAX_CHAIN_OPERANDS];
+static UC_NOINIT chain_operand_t rpc_chain_operands[RPC_MAX_CHAIN_OPERANDS];
+static UC_NOINIT chain_state_t rpc_chain_state; // 每次请求前清零
+
+/**
+ * 带边界检查的负载读写游标，越界后 ok 置 false
+ */
+typedef struct {
+  uint8_t *pos;
+  uint8_t *end;
+  bool ok;
+} rpc_cursor_t;
+
+static bool rpc_take(rpc_cursor_t *c, void *data, uint32_t size) {
+  if (!c->ok || (uint32_t)(c->end - c->pos) < size) {
+    c->ok = false;
+    return false;
+  }
+  memcpy(data, c->pos, size);
+  c->pos += size;
+  return true;
+}
+
+static void rpc_put(rpc_cursor_t *c, const void *data, uint32_t size) {
+  if (!c->ok || (uint32_t)(c->end - c->pos) < size) {
+    c->ok = false;
+    return;
+  }
+  memcpy(c->pos, data, size);
+  c->pos += size;
+}
+
+// 小端序 (目标与主机均为小端，见 universal_caller.h)
+static uint32_t rpc_get_u8(rpc_cursor_t *c) {
+  uint8_t v = 0;
+  rpc_take(c, &v, 1);
+  return v;
+}
+
+static uint32_t rpc_get_u16(rpc_cursor_t *c) {
+  uint16_t v = 0;
+  rpc_take(c, &v, 2);
+  return v;
+}
+
+static uint32_t rpc_get_u32(rpc_cursor_t *c) {
+  uint32_t v = 0;
+  rpc_take(c, &v, 4);
+  return v;
+}
+
+// len:u16 + 内容，返回指向接收缓冲区中内容的指针
+static void *rpc_get_bytes(rpc_cursor_t *c) {
+  uint32_t len = rpc_get_u16(c);
+  void *data = c->pos;
+  if (c->ok && (uint32_t)(c->end - c->pos) >= len) {
+    c->pos += len;
+  } else {
+    c->ok = false;
+  }
+  return data;
+}
+
+static void rpc_send(rpc_status_t status, const uint8_t *payload, uint32_t len) {
+  uart_putc(RPC_REPLY_MAGIC);
+  uart_putc(status);
+  uart_putc(len & 0xFF);
+  uart_putc(len >> 8);
+  for (uint32_t i = 0; i < len; i++) {
+    uart_putc(payload[i]);
+  }
+}
+
+static rpc_status_t rpc_list(const loader_export_t *table, uint32_t count,
+                             rpc_cursor_t *out) {
+  uint16_t n = count;
+  rpc_put(out, &n, 2);
+  for (uint32_t id = 0; id < count; id++) {
+    const loader_export_t *entry = &table[id];
+    uint8_t header[2] = {entry->ret_type, entry->arg_count};
+    rpc_put(out, header, 2);
+    for (int32_t i = 0; i < entry->arg_count; i++) {
+      uint8_t type = entry->arg_types[i];
+      rpc_put(out, &type, 1);
+    }
+    uint8_t name_len = strlen(entry->name);
+    rpc_put(out, &name_len, 1);
+    rpc_put(out, entry->name, name_len);
+  }
+  return out->ok ? RPC_STATUS_OK : RPC_STATUS_TOO_LARGE;
+}
+
+static rpc_status_t rpc_decode_arg(rpc_cursor_t *in, arg_t *arg) {
+  switch (arg->type) {
+  case ARG_CHAR:
+  case ARG_SHORT:
+  case ARG_INT:
+  case ARG_FLOAT: // 4 字节 (float 为位模式)
+    rpc_take(in, &arg->value.i, 4);
+    break;
+  case ARG_LONG: {
+    int64_t v = 0;
+    rpc_take(in, &v, 8);
+    arg->value.l = (long)v;
+    break;
+  }
+  case ARG_LONG_LONG:
+  case ARG_DOUBLE:
+    rpc_take(in, &arg->value.ll, 8);
+    break;
+  case ARG_POINTER: // 长度 + 内容，指向接收缓冲区
+    arg->value.p = rpc_get_bytes(in);
+    break;
+  default:
+    return RPC_STATUS_BAD_FRAME;
+  }
+  return in->ok ? RPC_STATUS_OK : RPC_STATUS_BAD_FRAME;
+}
+
+static void rpc_encode_ret(rpc_cursor_t *out, ret_type_t type,
+                           const return_value_t *ret) {
+  int32_t v32;
+  int64_t v64;
+  switch (type) {
+  case RET_CHAR:
+    v32 = ret->c;
+    rpc_put(out, &v32, 4);
+    break;
+  case RET_SHORT:
+    v32 = ret->s;
+    rpc_put(out, &v32, 4);
+    break;
+  case RET_INT:
+  case RET_FLOAT:
+    rpc_put(out, &ret->i, 4);
+    break;
+  case RET_LONG:
+    v64 = ret->l;
+    rpc_put(out, &v64, 8);
+    break;
+  case RET_LONG_LONG:
+  case RET_DOUBLE:
+    rpc_put(out, &ret->ll, 8);
+    break;
+  case RET_POINTER:
+    v64 = (intptr_t)ret->p;
+    rpc_put(out, &v64, 8);
+    break;
+  default: // RET_VOID
+    break;
+  }
+}
+
+static rpc_status_t rpc_call(const loader_export_t *table, uint32_t count,
+                             rpc_cursor_t *in, rpc_cursor_t *out) {
+  uint16_t n = rpc_get_u16(in);
+  rpc_put(out, &n, 2);
+  for (uint32_t k = 0; k < n; k++) {
+    uint32_t id = rpc_get_u8(in);
+    if (!in->ok) {
+      return RPC_STATUS_BAD_FRAME;
+    }
+    if (id >= count) {
+      return RPC_STATUS_BAD_ID;
+    }
+    const loader_export_t *entry = &table[id];
+    if (entry->arg_count > RPC_MAX_ARGS) {
+      return RPC_STATUS_BAD_FRAME;
+    }
+
+    arg_t args[RPC_MAX_ARGS];
+    for (int32_t i = 0; i < entry->arg_count; i++) {
+      args[i].type = entry->arg_types[i];
+      rpc_status_t status = rpc_decode_arg(in, &args[i]);
+      if (status != RPC_STATUS_OK) {
+        return status;
+      }
+    }
+
+    func_t func = {.func = entry->func,
+                   .ret_type = entry->ret_type,
+                   .arg_count = entry->arg_count,
+                   .args = args};
+    return_value_t ret = universal_caller(&func);
+    rpc_encode_ret(out, entry->ret_type, &ret);
+    if (!out->ok) {
+      return RPC_STATUS_TOO_LARGE;
+    }
+  }
+  return RPC_STATUS_OK;
+}
+
+static rpc_status_t rpc_decode_operand(rpc_cursor_t *in,
+                                      chain_operand_t *operand) {
+  *operand = (chain_operand_t){.src = rpc_get_u8(in)};
+  switch (operand->src) {
+  case CHAIN_SRC_RESULT:
+  case CHAIN_SRC_SCRATCH:
+    operand->index = rpc_get_u8(in);
+    break;
+  case CHAIN_SRC_CONST:
+    operand->value.type = rpc_get_u8(in);
+    switch (operand->value.type) {
+    case RET_LONG_LONG:
+    case RET_DOUBLE: // 8 字节 (double 为位模式)
+      rpc_take(in, &operand->value.value.ll, 8);
+      break;
+    case RET_POINTER:
+      operand->value.value.p = rpc_get_bytes(in);
+      break;
+    default:
+      return RPC_STATUS_BAD_FRAME;
+    }
+    break;
+  default:
+    return RPC_STATUS_BAD_FRAME;
+  }
+  return in->ok ? RPC_STATUS_OK : RPC_STATUS_BAD_FRAME;
+}
+
+static rpc_status_t rpc_decode_insn(const loader_export_t *table,
+                                    uint32_t count, rpc_cursor_t *in,
+                                    chain_insn_t *insn, func_t *func,
+                                    uint32_t *operands_used) {
+  *insn = (chain_insn_t){.op = rpc_get_u8(in)};
+  insn->dst = rpc_get_u8(in);
+  insn->target = rpc_get_u16(in);
+  rpc_status_t status = RPC_STATUS_OK;
+  switch (insn->op) {
+  case CHAIN_OP_CALL: {
+    uint32_t id = rpc_get_u8(in);
+    if (!in->ok) {
+      return RPC_STATUS_BAD_FRAME;
+    }
+    if (id >= count) {
+      return RPC_STATUS_BAD_ID;
+    }
+    const loader_export_t *entry = &table[id];
+    if (entry->arg_count > RPC_MAX_ARGS) {
+      return RPC_STATUS_BAD_FRAME;
+    }
+    if (*operands_used + entry->arg_count > RPC_MAX_CHAIN_OPERANDS) {
+      return RPC_STATUS_TOO_LARGE;
+    }
+    arg_t *args = &rpc_chain_args[*operands_used];
+    chain_operand_t *operands = &rpc_chain_operands[*operands_used];
+    *operands_used += entry->arg_count;
+    for (int32_t i = 0; i < entry->arg_count && status == RPC_STATUS_OK; i++) {
+      args[i] = (arg_t){.type = entry->arg_types[i]};
+      status = rpc_decode_operand(in, &operands[i]);
+    }
+    *func = (func_t){.func = entry->func,
+                     .ret_type = entry->ret_type,
+                     .arg_count = entry->arg_count,
+                     .args = args};
+    insn->func = func;
+    insn->operands = operands;
+    break;
+  }
+  case CHAIN_OP_ADD:
+  case CHAIN_OP_JLT:
+    status = rpc_decode_operand(in, &insn->a);
+    if (status == RPC_STATUS_OK) {
+      status = rpc_decode_operand(in, &insn->b);
+    }
+    break;
+  case CHAIN_OP_SET:
+  case CHAIN_OP_JZ:
+  case CHAIN_OP_JNZ:
+  case CHAIN_OP_EMIT:
+    status = rpc_decode_operand(in, &insn->a);
+    break;
+  case CHAIN_OP_JMP:
+  case CHAIN_OP_HALT:
+    break;
+  default:
+    return RPC_STATUS_BAD_FRAME;
+  }
+  if (status == RPC_STATUS_OK && !in->ok) {
+    status = RPC_STATUS_BAD_FRAME;
+  }
+  return status;
+}
+
+/**
+ * 解码并执行链程序，只返回 EMIT 的值
+ */
+static rpc_status_t rpc_chain(const loader_export_t *table, uint32_t count,
+                              rpc_cursor_t *in, rpc_cursor_t *out) {
+  chain_program_t program = {.insns = rpc_chain_insns,
+                             .insn_count = rpc_get_u16(in)};
+  program.max_steps = rpc_get_u32(in);
+  if (!in->ok) {
+    return RPC_STATUS_BAD_FRAME;
+  }
+  if (program.insn_count > RPC_MAX_CHAIN_INSNS) {
+    return RPC_STATUS_TOO_LARGE;
+  }
+  uint32_t operands_used = 0;
+  for (uint32_t i = 0; i < program.insn_count; i++) {
+    rpc_status_t status =
+        rpc_decode_insn(table, count, in, &rpc_chain_insns[i],
+                        &rpc_chain_funcs[i], &operands_used);
+    if (status != RPC_STATUS_OK) {
+      return status;
+    }
+  }
+
+  chain_state_t *state = &rpc_chain_state;
+  *state = (chain_state_t){0};
+  uint8_t chain_status = chain_run(&program, state);
+  uint8_t output_count = state->output_count;
+  rpc_put(out, &chain_status, 1);
+  rpc_put(out, &state->steps, 4);
+  rpc_put(out, &state->calls, 4);
+  rpc_put(out, &output_count, 1);
+  for (uint32_t i = 0; i < state->output_count; i++) {
+    const chain_value_t *value = &state->output[i];
+    uint8_t type = value->type;
+    rpc_put(out, &type, 1);
+    if (type == RET_FLOAT || type == RET_DOUBLE) {
+      double d = chain_value_double(value);
+      rpc_put(out, &d, 8);
+    } else {
+      int64_t v = chain_value_int(value);
+      rpc_put(out, &v, 8);
+    }
+  }
+  return out->ok ? RPC_STATUS_OK : RPC_STATUS_TOO_LARGE;
+}
+
+void rpc_serve(const loader_export_t *table, uint32_t count) {
+  static const uint8_t hello[] = {'U', 'C', 'R', 'P', 'C', sizeof(void *)};
+  rpc_send(RPC_STATUS_OK, hello, sizeof(hello));
+
+  while (1) {
+    while ((uint8_t)uart_getc() != RPC_REQUEST_MAGIC) // 按帧头重新同步
+      ;
+    uint32_t op = (uint8_t)uart_getc();
+    uint32_t len = (uint8_t)uart_getc();
+    len |= (uint32_t)(uint8_t)uart_getc() << 8;
+
+    if (len > RPC_MAX_FRAME) {
+      for (uint32_t i = 0; i < len; i++) {
+        uart_getc();
+      }
+      rpc_send(RPC_STATUS_TOO_LARGE, NULL, 0);
+      continue;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+      rpc_rx[i] = uart_getc();
+    }
+
+    rpc_cursor_t in = {rpc_rx, rpc_rx + len, true};
+    rpc_cursor_t out = {rpc_tx, rpc_tx + RPC_MAX_FRAME, true};
+    rpc_status_t status;
+    switch (op) {
+    case RPC_OP_PING:
+    case RPC_OP_QUIT:
+      status = RPC_STATUS_OK;
+      break;
+    case RPC_OP_LIST:
+      status = rpc_list(table, count, &out);
+      break;
+    case RPC_OP_CALL:
+      status = rpc_call(table, count, &in, &out);
+      break;
+    case RPC_OP_CHAIN:
+      status = rpc_chain(table, count, &in, &out);
+      break;
+    default:
+      status = RPC_STATUS_BAD_FRAME;
+      break;
+    }
+
+    rpc_send(status, rpc_tx, status == RPC_STATUS_OK ? out.pos - rpc_tx : 0);
+    if (op == RPC_OP_QUIT) {
+      return;
+    }
+  }
+}
@@ -0,0 +1,83 @@
+/**
+ * rpc.h - Serial call server for end-to-end measurements
+ *
+ * rpc_serve() answers binary request frames on the UART and calls registered
+ * functions through universal_caller(). tools/uc_bench.py drives it from the
+ * host (make RPC=1 bench-e2e), so host encoding, transport, dispatch and
+ * result return are measured together.
+ *
+ * Frames (little-endian): magic, op/status, 16-bit payload length, payload.
+ *
+ *   RPC_OP_PING  -                          -> -
+ *   RPC_OP_LIST  -                          -> count:u16, then per entry
+ *                                              ret:u8 argc:u8 types:u8[argc]
+ *                                              name_len:u8 name
+ *   RPC_OP_CALL  count:u16, then per call   -> count:u16, then per call the
+ *                id:u8 and the arguments       return value
+ *   RPC_OP_QUIT  -                          -> - (rpc_serve() returns)
+ *   RPC_OP_CHAIN insn_count:u16             -> status:u8 (chain_status_t)
+ *                max_steps:u32, then the       steps:u32 calls:u32
+ *                instructions                  count:u8, then per EMIT
+ *                                              type:u8 value:8 bytes
+ *
+ * RPC_OP_CHAIN runs a chain program (chain.h), so a multi-step operation whose
+ * calls depend on each other's results takes one round trip instead of one per
+ * call. Each instruction is op:u8 dst:u8 target:u16, followed by
+ *   CALL            id:u8, then one operand per argument of that function
+ *   SET/JZ/JNZ/EMIT operand a
+ *   ADD/JLT         operands a and b
+ *   JMP/HALT        -
+ * An operand is src:u8 (chain_src_t) followed by index:u8 for RESULT/SCRATCH
+ * or by type:u8 and the value for CONST: LONG_LONG and DOUBLE take 8 bytes,
+ * POINTER is len:u16 followed by len bytes (as for CALL arguments). Emitted
+ * FLOAT/DOUBLE values are returned as a double, all others as a 64-bit
+ * integer.
+ *
+ * On the wire, CHAR/SHORT/INT/FLOAT values take 4 bytes, and LONG/LONG_LONG/
+ * DOUBLE take 8 bytes. A POINTER argument is len:u16 followed by len bytes;
+ * the function receives a pointer to those bytes in the receive buffer.
+ * Return values use the same widths (POINTER returns 8 bytes, VOID none).
+ * After startup the server sends one RPC_STATUS_OK frame with payload
+ * "UCRPC" and the XLEN in bytes. Boot output (boot_report()) may precede it
+ * and can contain RPC_REPLY_MAGIC, so a client syncs on the whole hello frame
+ * (5A 00 06 00 'UCRPC'), not on the first magic byte.
+ */
+
+#ifndef RPC_H
+#define RPC_H
+
+#include "loader.h"
+
+#define RPC_MAX_FRAME 4096 // 单帧负载上限 (收发缓冲区大小)
+#define RPC_MAX_ARGS 20    // 单次调用的最大参数数量
+#define RPC_MAX_CHAIN_INSNS 64     // RPC_OP_CHAIN 程序的最大指令数
+#define RPC_MAX_CHAIN_OPERANDS 256 // RPC_OP_CHAIN 程序中 CALL 参数的总数
+
+#define RPC_REQUEST_MAGIC 0xA5
+#define RPC_REPLY_MAGIC 0x5A
+
+typedef enum {
+  RPC_OP_PING = 0,
+  RPC_OP_LIST = 1,
+  RPC_OP_CALL = 2,
+  RPC_OP_QUIT = 3,
+  RPC_OP_CHAIN = 4,
+} rpc_op_t;
+
+typedef enum {
+  RPC_STATUS_OK = 0,
+  RPC_STATUS_BAD_FRAME = 1, // 未知操作或负载格式错误
+  RPC_STATUS_BAD_ID = 2,    // 调用了不存在的函数序号
+  RPC_STATUS_TOO_LARGE = 3, // 请求或应答超过 RPC_MAX_FRAME (或链程序超过上限)
+} rpc_status_t;
+
+/**
+ * Serve requests until RPC_OP_QUIT
+ *
+ * @param table Callable functions, identified by their index in the table
+ *              (same entry format as module exports, see loader.h)
+ * @param count Number of entries
+ */
+void rpc_serve(const loader_export_t *table, uint32_t count);
+
+#endif /* RPC_H */
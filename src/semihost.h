@@ -0,0 +1,51 @@
+/**
+ * semihost.h - RISC-V semihosting calls
+ *
+ * semihost_call() issues the semihosting trap sequence
+ * (slli x0, x0, 0x1f; ebreak; srai x0, x0, 7). A debugger or QEMU
+ * (-semihosting-config enable=on) then performs the operation on the host.
+ * Operation numbers and parameter blocks follow the Arm semihosting
+ * specification, with XLEN-wide fields.
+ *
+ * With USE_SEMIHOSTING (make SEMIHOSTING=1), syscalls.c routes
+ * _open/_read/_write/_lseek/_close/_fstat on files to the host, so fopen()/
+ * fread()/fwrite() access host files at memory speed. stdin/stdout/stderr stay
+ * on the UART. _exit() ends QEMU with the exit status.
+ */
+
+#ifndef SEMIHOST_H
+#define SEMIHOST_H
+
+#include <stdint.h>
+
+#define SEMIHOST_SYS_OPEN 0x01
+#define SEMIHOST_SYS_CLOSE 0x02
+#define SEMIHOST_SYS_WRITE 0x05
+#define SEMIHOST_SYS_READ 0x06
+#define SEMIHOST_SYS_ISTTY 0x09
+#define SEMIHOST_SYS_SEEK 0x0A
+#define SEMIHOST_SYS_FLEN 0x0C
+#define SEMIHOST_SYS_REMOVE 0x0E
+#define SEMIHOST_SYS_ERRNO 0x13
+#define SEMIHOST_SYS_EXIT_EXTENDED 0x20
+
+#define SEMIHOST_ADP_STOPPED_APPLICATION_EXIT 0x20026
+
+// SYS_OPEN 的模式 (对应 fopen 的模式字符串)
+#define SEMIHOST_OPEN_RB 1   // "rb"
+#define SEMIHOST_OPEN_RPB 3  // "r+b"
+#define SEMIHOST_OPEN_WB 5   // "wb"
+#define SEMIHOST_OPEN_WPB 7  // "w+b"
+#define SEMIHOST_OPEN_AB 9   // "ab"
+#define SEMIHOST_OPEN_APB 11 // "a+b"
+
+/**
+ * Issue a semihosting operation (semihost_entry.S)
+ *
+ * @param op  SEMIHOST_SYS_* operation number
+ * @param arg Parameter block (array of XLEN-wide fields) or immediate value
+ * @return Operation result (a0)
+ */
+long semihost_call(long op, const void *arg);
+
+#endif /* SEMIHOST_H */
@@ -5,10 +5,70 @@
 #include <stdint.h>
 #include <sys/stat.h>
 
+#ifdef USE_SEMIHOSTING
+#include "semihost.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SEMIHOST_FD_BASE 3   // 0-2 (stdin/stdout/stderr) 仍使用UART
+#define SEMIHOST_MAX_FILES 8 // 同时打开的主机文件数
+
+typedef struct {
+  long handle; // 主机端句柄, -1 表示空闲
+  long pos;    // 当前位置 (SYS_SEEK 只支持绝对位置，SEEK_CUR 需自行跟踪)
+} semihost_file_t;
+
+static semihost_file_t semihost_files[SEMIHOST_MAX_FILES] = {
+    [0 ... SEMIHOST_MAX_FILES - 1] = {.handle = -1}};
+
+static semihost_file_t *semihost_file(int fd) {
+  if (fd < SEMIHOST_FD_BASE || fd >= SEMIHOST_FD_BASE + SEMIHOST_MAX_FILES) {
+    return NULL;
+  }
+  semihost_file_t *file = &semihost_files[fd - SEMIHOST_FD_BASE];
+  return file->handle >= 0 ? file : NULL;
+}
+
+static int semihost_fail(void) {
+  errno = semihost_call(SEMIHOST_SYS_ERRNO, NULL);
+  return -1;
+}
+
+// open() 标志转换为 SYS_OPEN 模式 (总是二进制模式)
+static long semihost_open_mode(int flags) {
+  int access = flags & O_ACCMODE;
+  if (flags & O_APPEND) {
+    return access == O_RDWR ? SEMIHOST_OPEN_APB : SEMIHOST_OPEN_AB;
+  }
+  if (access == O_RDONLY) {
+    return SEMIHOST_OPEN_RB;
+  }
+  if (flags & (O_CREAT | O_TRUNC)) {
+    return access == O_RDWR ? SEMIHOST_OPEN_WPB : SEMIHOST_OPEN_WB;
+  }
+  return SEMIHOST_OPEN_RPB; // 打开已有文件写入，不截断
+}
+#endif
+
 #pragma weak _write
 #pragma weak _read
 
-int _write(int fd __unused, char *ptr, int len) {
+int _write(int fd, char *ptr, int len) {
+#ifdef USE_SEMIHOSTING
+  semihost_file_t *file = semihost_file(fd);
+  if (file != NULL) {
+    uintptr_t block[3] = {file->handle, (uintptr_t)ptr, len};
+    long written = len - semihost_call(SEMIHOST_SYS_WRITE, block); // 返回未写入的字节数
+    if (written == 0 && len > 0) {
+      return semihost_fail();
+    }
+    file->pos += written;
+    return written;
+  }
+#else
+  (void)fd;
+#endif
   int i;
   for (i = 0; i < len; i++) {
     uart_putc(ptr[i]);
@@ -18,7 +78,21 @@ int _write(int fd __unused, char *ptr, int len) {
   return i;
 }
 
-int _read(int fd __unused, char *ptr, int len) {
+int _read(int fd, char *ptr, int len) {
+#ifdef USE_SEMIHOSTING
+  semihost_file_t *file = semihost_file(fd);
+  if (file != NULL) {
+    uintptr_t block[3] = {file->handle, (uintptr_t)ptr, len};
+    long left = semihost_call(SEMIHOST_SYS_READ, block); // 返回未读取的字节数
+    if (left < 0 || left > len) {
+      return semihost_fail();
+    }
+    file->pos += len - left;
+    return len - left;
+  }
+#else
+  (void)fd;
+#endif
   int i;
   for (i = 0; i < len; i++)
     ptr[i] = uart_getc();
@@ -26,31 +100,104 @@ int _read(int fd __unused, char *ptr, int len) {
 }
 
 /* _exit */
-__attribute__((__used__)) void _exit(int status __unused) {
+__attribute__((__used__)) void _exit(int status) {
+#ifdef USE_SEMIHOSTING
+  // 以 status 作为 QEMU 的退出码
+  uintptr_t block[2] = {SEMIHOST_ADP_STOPPED_APPLICATION_EXIT, status};
+  semihost_call(SEMIHOST_SYS_EXIT_EXTENDED, block);
+#else
+  (void)status;
+#endif
   while (1)
     ;
 }
 
 /* close */
-__attribute__((__used__)) int _close(int file __unused) { return -1; }
+__attribute__((__used__)) int _close(int file) {
+#ifdef USE_SEMIHOSTING
+  semihost_file_t *sh_file = semihost_file(file);
+  if (sh_file != NULL) {
+    uintptr_t block[1] = {sh_file->handle};
+    sh_file->handle = -1;
+    return semihost_call(SEMIHOST_SYS_CLOSE, block) == 0 ? 0 : semihost_fail();
+  }
+#else
+  (void)file;
+#endif
+  return -1;
+}
 
 /* fstat */
-__attribute__((__used__)) int _fstat(int file __unused, struct stat *st) {
+__attribute__((__used__)) int _fstat(int file, struct stat *st) {
+#ifdef USE_SEMIHOSTING
+  semihost_file_t *sh_file = semihost_file(file);
+  if (sh_file != NULL) {
+    uintptr_t block[1] = {sh_file->handle};
+    long length = semihost_call(SEMIHOST_SYS_FLEN, block);
+    if (length < 0) {
+      return semihost_fail(); // SYS_FLEN 失败时返回 -1
+    }
+    memset(st, 0, sizeof(*st));
+    st->st_mode = S_IFREG;
+    st->st_size = length;
+    return 0;
+  }
+#else
+  (void)file;
+#endif
   st->st_mode = S_IFCHR;
   return 0;
 }
 
 __attribute__((__used__)) int _getpid(void) { return 1; }
 
-__attribute__((__used__)) int _isatty(int file __unused) { return 1; }
+__attribute__((__used__)) int _isatty(int file) {
+#ifdef USE_SEMIHOSTING
+  if (semihost_file(file) != NULL) {
+    return 0;
+  }
+#else
+  (void)file;
+#endif
+  return 1;
+}
 
 __attribute__((__used__)) int _kill(int pid __unused, int sig __unused) {
   errno = EINVAL;
   return -1;
 }
 
-__attribute__((__used__)) int _lseek(int file __unused, int ptr __unused,
-                                     int dir __unused) {
+__attribute__((__used__)) int _lseek(int file, int ptr, int dir) {
+#ifdef USE_SEMIHOSTING
+  semihost_file_t *sh_file = semihost_file(file);
+  if (sh_file != NULL) {
+    uintptr_t block[2] = {sh_file->handle, 0};
+    long pos = ptr;
+    if (dir == SEEK_CUR) {
+      pos += sh_file->pos;
+    } else if (dir == SEEK_END) {
+      long length = semihost_call(SEMIHOST_SYS_FLEN, block);
+      if (length < 0) {
+        return semihost_fail();
+      }
+      pos += length;
+    }
+    if (pos < 0) {
+      errno = EINVAL;
+      return -1;
+    }
+    block[1] = pos;
+    if (semihost_call(SEMIHOST_SYS_SEEK, block) != 0) {
+      return semihost_fail();
+    }
+    sh_file->pos = pos;
+    return pos;
+  }
+#else
+  (void)file;
+  (void)ptr;
+  (void)dir;
+#endif
   return 0;
 }
 
@@ -80,7 +227,31 @@ link(char *old __unused, char *new __unused) {
 }
 
 __attribute__((__used__)) __attribute__((__used__)) int
-_open(const char *name __unused, int flags __unused, int mode __unused) {
+_open(const char *name, int flags, int mode __unused) {
+#ifdef USE_SEMIHOSTING
+  for (int i = 0; i < SEMIHOST_MAX_FILES; i++) {
+    if (semihost_files[i].handle >= 0) {
+      continue;
+    }
+    uintptr_t block[3] = {(uintptr_t)name, semihost_open_mode(flags),
+                          strlen(name)};
+    long handle = semihost_call(SEMIHOST_SYS_OPEN, block);
+    if (handle < 0) {
+      return semihost_fail();
+    }
+    semihost_files[i].handle = handle;
+    semihost_files[i].pos = 0;
+    if (flags & O_APPEND) { // 追加模式从文件末尾开始
+      uintptr_t flen_block[1] = {handle};
+      semihost_files[i].pos = semihost_call(SEMIHOST_SYS_FLEN, flen_block);
+    }
+    return SEMIHOST_FD_BASE + i;
+  }
+  errno = EMFILE;
+#else
+  (void)name;
+  (void)flags;
+#endif
   return -1;
 }
 
@@ -107,9 +278,15 @@ stat(const char *__restrict __path __unused, struct stat *__restrict __sbuf) {
 // }
 
 __attribute__((__used__)) __attribute__((__used__)) int
-unlink(char *name __unused) {
+unlink(char *name) {
+#ifdef USE_SEMIHOSTING
+  uintptr_t block[2] = {(uintptr_t)name, strlen(name)};
+  return semihost_call(SEMIHOST_SYS_REMOVE, block) == 0 ? 0 : semihost_fail();
+#else
+  (void)name;
   errno = ENOENT;
   return -1;
+#endif
 }
 
 __attribute__((__used__)) __attribute__((__used__)) int
@@ -0,0 +1,126 @@
+#include "trap.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+extern char trap_entry[];
+
+static timer_client_t *timer_clients = NULL;
+static bool trap_initialized = false;
+
+static inline uxlen_t hart_id(void) {
+  uxlen_t id;
+  asm volatile("csrr %0, mhartid" : "=r"(id));
+  return id;
+}
+
+uint64_t timer_now(void) {
+#if __riscv_xlen == 32
+  volatile uint32_t *mtime = (volatile uint32_t *)CLINT_MTIME;
+  uint32_t hi, lo;
+  do { // 读取高位-低位-高位，避免低位进位造成的撕裂
+    hi = mtime[1];
+    lo = mtime[0];
+  } while (hi != mtime[1]);
+  return ((uint64_t)hi << 32) | lo;
+#else
+  return *(volatile uint64_t *)CLINT_MTIME;
+#endif
+}
+
+static void timer_set_compare(uint64_t deadline) {
+#if __riscv_xlen == 32
+  volatile uint32_t *mtimecmp = (volatile uint32_t *)CLINT_MTIMECMP(hart_id());
+  mtimecmp[1] = 0xFFFFFFFF; // 先抬高高位，避免更新过程中误触发
+  mtimecmp[0] = (uint32_t)deadline;
+  mtimecmp[1] = (uint32_t)(deadline >> 32);
+#else
+  *(volatile uint64_t *)CLINT_MTIMECMP(hart_id()) = deadline;
+#endif
+}
+
+// 将 mtimecmp 设为所有客户端中最早的截止时间
+static void timer_reprogram(void) {
+  uint64_t earliest = UINT64_MAX;
+  for (timer_client_t *c = timer_clients; c != NULL; c = c->next) {
+    if (c->deadline < earliest) {
+      earliest = c->deadline;
+    }
+  }
+  timer_set_compare(earliest);
+}
+
+// 修改客户端链表/截止时间期间屏蔽中断
+static inline uxlen_t irq_save(void) {
+  uxlen_t mstatus;
+  asm volatile("csrrc %0, mstatus, %1"
+               : "=r"(mstatus)
+               : "r"((uxlen_t)MSTATUS_MIE)
+               : "memory");
+  return mstatus & MSTATUS_MIE;
+}
+
+static inline void irq_restore(uxlen_t mie) {
+  asm volatile("csrs mstatus, %0" ::"r"(mie) : "memory");
+}
+
+void trap_init(void) {
+  if (trap_initialized) {
+    return;
+  }
+  trap_initialized = true;
+  timer_set_compare(UINT64_MAX);
+  asm volatile("csrw mtvec, %0" ::"r"(trap_entry));
+  asm volatile("csrs mie, %0" ::"r"((uxlen_t)MIE_MTIE));
+  asm volatile("csrs mstatus, %0" ::"r"((uxlen_t)MSTATUS_MIE));
+}
+
+void timer_register(timer_client_t *client, timer_handler_t handler) {
+  uxlen_t mie = irq_save();
+  client->deadline = UINT64_MAX;
+  client->handler = handler;
+  client->next = timer_clients;
+  timer_clients = client;
+  irq_restore(mie);
+}
+
+void timer_arm(timer_client_t *client, uint64_t deadline) {
+  uxlen_t mie = irq_save();
+  client->deadline = deadline;
+  timer_reprogram();
+  irq_restore(mie);
+}
+
+void timer_disarm(timer_client_t *client) {
+  uxlen_t mie = irq_save();
+  client->deadline = UINT64_MAX;
+  timer_reprogram();
+  irq_restore(mie);
+}
+
+static void timer_interrupt(trap_frame_t *frame) {
+  uint64_t now = timer_now();
+  for (timer_client_t *c = timer_clients; c != NULL; c = c->next) {
+    if (c->deadline <= now) {
+      c->deadline = UINT64_MAX;
+      c->handler(c, frame);
+    }
+  }
+  timer_reprogram();
+}
+
+/**
+ * Called from trap_entry with interrupts disabled (mstatus.MIE cleared)
+ */
+void trap_handler(trap_frame_t *frame) {
+  if (frame->mcause == (MCAUSE_INTERRUPT | MCAUSE_MACHINE_TIMER)) {
+    timer_interrupt(frame);
+    return;
+  }
+
+  printf("\nUnhandled trap: mcause=0x%lx mepc=0x%lx mtval=0x%lx\n",
+         (unsigned long)frame->mcause, (unsigned long)frame->mepc,
+         (unsigned long)frame->mtval);
+  while (1)
+    asm volatile("");
+}
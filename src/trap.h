@@ -0,0 +1,105 @@
+/**
+ * trap.h - Machine-mode trap entry and CLINT timer multiplexing
+ *
+ * trap_init() points mtvec at trap_entry (trap_entry.S), which saves the full
+ * register state into a trap_frame_t on the interrupted stack and calls
+ * trap_handler(). Handlers may modify the frame (mepc, registers); the
+ * modified state is restored by mret. With the V extension, v0-v31 are saved
+ * below the frame (32 * vlenb bytes) and vstart/vl/vtype in it, so handlers
+ * compiled for rv*v may use vector instructions even when the interrupted
+ * code is in the middle of a vector sequence.
+ *
+ * The single CLINT mtimecmp of the hart is shared by timer clients: each client
+ * has its own deadline, and mtimecmp is always programmed to the earliest one.
+ */
+
+#ifndef TRAP_H
+#define TRAP_H
+
+#include "riscv_abi.h"
+
+// QEMU virt CLINT
+#define CLINT_BASE 0x02000000
+#define CLINT_MTIMECMP(hart) (CLINT_BASE + 0x4000 + 8 * (hart))
+#define CLINT_MTIME (CLINT_BASE + 0xBFF8)
+#define CLINT_TIMEBASE_HZ 10000000 // QEMU virt mtime 频率 10MHz
+
+// trap_frame_t 布局 (trap_entry.S 与 C 共用)
+#define TRAP_FRAME_X 0                       // x0-x31, 每个 XLEN (x2 为被中断的sp)
+#define TRAP_FRAME_F (32 * XLEN)             // f0-f31, 每个 8 字节
+#define TRAP_FRAME_MEPC (TRAP_FRAME_F + 256) // mepc
+#define TRAP_FRAME_MCAUSE (TRAP_FRAME_MEPC + XLEN)
+#define TRAP_FRAME_MTVAL (TRAP_FRAME_MEPC + 2 * XLEN)
+#define TRAP_FRAME_FCSR (TRAP_FRAME_MEPC + 3 * XLEN)
+#define TRAP_FRAME_VSTART (TRAP_FRAME_MEPC + 4 * XLEN) // 向量状态 (V 扩展)
+#define TRAP_FRAME_VL (TRAP_FRAME_MEPC + 5 * XLEN)
+#define TRAP_FRAME_VTYPE (TRAP_FRAME_MEPC + 6 * XLEN)
+#define TRAP_FRAME_SIZE ((TRAP_FRAME_MEPC + 7 * XLEN + 15) & ~15)
+
+#define MCAUSE_INTERRUPT ((uxlen_t)1 << (XLEN * 8 - 1))
+#define MCAUSE_MACHINE_TIMER 7
+#define MIE_MTIE (1 << 7)
+#define MSTATUS_MIE (1 << 3)
+
+#ifndef __ASSEMBLER__
+#include <stdint.h>
+
+typedef struct {
+  uxlen_t x[32];  // x0-x31 (x[2] = sp at the time of the trap)
+  uint64_t f[32]; // f0-f31 (单精度时只用低32位)
+  uxlen_t mepc;
+  uxlen_t mcause;
+  uxlen_t mtval;
+  uxlen_t fcsr;
+  uxlen_t vstart; // 以下仅在 V 扩展时保存
+  uxlen_t vl;
+  uxlen_t vtype;
+} trap_frame_t;
+
+_Static_assert(__builtin_offsetof(trap_frame_t, vtype) == TRAP_FRAME_VTYPE,
+               "trap_frame_t 布局须与 TRAP_FRAME_* 一致");
+_Static_assert(sizeof(trap_frame_t) <= TRAP_FRAME_SIZE,
+               "TRAP_FRAME_SIZE 过小");
+
+typedef struct timer_client timer_client_t;
+
+/**
+ * Called from the timer interrupt once `deadline` has passed. The client is
+ * disarmed before the call; call timer_arm() again for periodic operation.
+ */
+typedef void (*timer_handler_t)(timer_client_t *client, trap_frame_t *frame);
+
+struct timer_client {
+  uint64_t deadline; // mtime deadline, UINT64_MAX when disarmed
+  timer_handler_t handler;
+  timer_client_t *next;
+};
+
+/**
+ * Install trap_entry in mtvec and enable machine timer interrupts (idempotent)
+ */
+void trap_init(void);
+
+/**
+ * Read the CLINT mtime counter
+ */
+uint64_t timer_now(void);
+
+/**
+ * Register a timer client (initially disarmed)
+ */
+void timer_register(timer_client_t *client, timer_handler_t handler);
+
+/**
+ * Arm a registered client for an absolute mtime deadline
+ */
+void timer_arm(timer_client_t *client, uint64_t deadline);
+
+/**
+ * Disarm a registered client
+ */
+void timer_disarm(timer_client_t *client);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* TRAP_H */
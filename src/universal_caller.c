@@ -1,19 +1,27 @@
 #include "universal_caller.h"
+#include "riscv_abi.h"
 #include <assert.h>
 #include <stddef.h>
+#include <string.h>
+
+#if __riscv_xlen == 32
+#define ABI_NAME "ilp32"
+#elif __riscv_xlen == 64
+#define ABI_NAME "lp64"
+#else
+#error "unknown xlen"
+#endif
 
 #if __riscv_float_abi_soft == 1
-#pragma message("ilp32")
+#pragma message(ABI_NAME)
 #elif __riscv_float_abi_single == 1
-#pragma message("ilp32f")
+#pragma message(ABI_NAME "f")
 #elif __riscv_float_abi_double == 1
-#pragma message("ilp32d")
+#pragma message(ABI_NAME "d")
 #else
 #error "unknown float abi"
 #endif
 
-#define XLEN 4 // 32bits = 4 * 8B = 32B
-
 //! (64 * XLEN bits)
 #define MAX_STACK_ARGS_SIZE 64
 
@@ -24,6 +32,62 @@ typedef union {
   uint64_t raw64;
 } fp_reg_t;
 
+#if UC_HAS_VECTOR
+//! 暂存区支持的最大 VLEN (bits)
+#define MAX_VLENB (512 / 8)
+//! 向量寄存器暂存区: [v0][v8..v15][v16..v23]，各 vlenb 字节，整寄存器加载/存储
+#define VREG_STAGE_SIZE (17 * MAX_VLENB)
+
+#define VECTOR_ARGS (1u << 0) // 调用前加载 v0/v8-v23
+#define VECTOR_RET (1u << 1)  // 调用后存储 v0/v8-v15
+
+static inline uint32_t vector_vlenb(void) {
+  uxlen_t vlenb;
+  asm volatile("csrr %0, vlenb" : "=r"(vlenb));
+  return vlenb;
+}
+
+// vtype: vlmul[2:0], vsew[5:3], vta=1, vma=1
+static inline uxlen_t vector_vtype(const vector_arg_t *v) {
+  return 0xC0 | ((__builtin_ctz(v->sew) - 3) << 3) | __builtin_ctz(v->lmul);
+}
+
+static inline uint32_t vector_bytes(const vector_arg_t *v, int is_mask) {
+  return is_mask ? (v->vl + 7) / 8 : v->vl * (v->sew / 8);
+}
+
+/**
+ * 按标准向量调用约定分配寄存器: 第一个掩码使用 v0，其余值 (含后续掩码, 按
+ * LMUL=1) 使用 v8-v23 中第一个按 LMUL 对齐的空闲寄存器组
+ *
+ * @param used 已占用的寄存器 (bit n 对应 vn)
+ * @return 寄存器组的首个寄存器号，寄存器不足时返回 -1 (按引用传递)
+ */
+static int vector_alloc(uint32_t *used, uint32_t lmul, int is_mask) {
+  if (is_mask) {
+    if (!(*used & 1u)) {
+      *used |= 1u;
+      return 0;
+    }
+    lmul = 1;
+  }
+  assert(lmul == 1 || lmul == 2 || lmul == 4 || lmul == 8);
+  uint32_t group = (1u << lmul) - 1;
+  for (uint32_t reg = 8; reg + lmul <= 24; reg += lmul) {
+    if (!(*used & (group << reg))) {
+      *used |= group << reg;
+      return reg;
+    }
+  }
+  return -1;
+}
+
+static inline uint8_t *vector_stage_reg(uint8_t *stage, uint32_t vlenb,
+                                        int reg) {
+  return stage + (reg == 0 ? 0 : (reg - 7) * vlenb);
+}
+#endif
+
 /**
  * 该实现将SP列入clobbers
  * 违反了GCC的以下限制:
@@ -48,75 +112,117 @@ typedef union {
 return_value_t universal_caller(func_t *func) {
   return_value_t result;
   void *function = func->func;
-  int32_t integar_argument_regs[8] = {0}; // a0-a7
+  xlen_t integar_argument_regs[8] = {0}; // a0-a7
   uint32_t integar_argument_regs_index = 0;
 #if __riscv_float_abi_soft != 1
   return_value_t result_fp;
   fp_reg_t fp_argument_regs[8] = {0}; // f0-f7
   uint32_t fp_argument_regs_index = 0;
 #endif
-  uint32_t stack_args[MAX_STACK_ARGS_SIZE] = {0};
+  uxlen_t stack_args[MAX_STACK_ARGS_SIZE] = {0};
   uint32_t stack_args_index = 0;
   uint32_t stack_args_size_needed = 0;
+#if UC_HAS_VECTOR
+  uint8_t vreg_stage[VREG_STAGE_SIZE] __attribute__((aligned(16)));
+  uint32_t vlenb = vector_vlenb();
+  uint32_t vector_regs_used = 0; // bit n 对应 vn
+  uint32_t vector_flags = 0;     // VECTOR_*
+  uxlen_t vector_vl = 0;         // 调用前 vsetvl 的参数: 第一个向量值
+  uxlen_t vector_vtype_value = 0xC0;
+  int vector_vtype_set = 0;
+  assert(vlenb <= MAX_VLENB);
+  if (func->ret_type == RET_VECTOR || func->ret_type == RET_VECTOR_MASK) {
+    vector_flags |= VECTOR_RET;
+  }
+#else
+  assert(func->ret_type != RET_VECTOR && func->ret_type != RET_VECTOR_MASK);
+#endif
 
 #define HANDLE_INTEGER_CALLING_CONVENTION_1XLEN                                \
   INTEGER_CALLING_CONVENTION_1XLEN:                                            \
   if (integar_argument_regs_index < 8) {                                       \
-    integar_argument_regs[integar_argument_regs_index++] =                     \
-        func->args[i].value.i;                                                 \
+    integar_argument_regs[integar_argument_regs_index++] = scalar;             \
   } else {                                                                     \
     assert(stack_args_index < MAX_STACK_ARGS_SIZE);                            \
-    stack_args[stack_args_index++] = func->args[i].value.i;                    \
+    stack_args[stack_args_index++] = scalar;                                   \
   }
 #define HANDLE_INTEGER_CALLING_CONVENTION_2XLEN                                \
   INTEGER_CALLING_CONVENTION_2XLEN:                                            \
   if (integar_argument_regs_index <= 6) {                                      \
+    integar_argument_regs[integar_argument_regs_index++] = (uxlen_t)scalar2x;  \
     integar_argument_regs[integar_argument_regs_index++] =                     \
-        (uint32_t)func->args[i].value.ll;                                      \
-    integar_argument_regs[integar_argument_regs_index++] =                     \
-        (uint32_t)(func->args[i].value.ll >> 32);                              \
+        (uxlen_t)(scalar2x >> (XLEN * 8));                                     \
   } else if (integar_argument_regs_index == 7) {                               \
-    integar_argument_regs[integar_argument_regs_index++] =                     \
-        (uint32_t)func->args[i].value.ll;                                      \
+    integar_argument_regs[integar_argument_regs_index++] = (uxlen_t)scalar2x;  \
     assert(stack_args_index < MAX_STACK_ARGS_SIZE);                            \
-    stack_args[stack_args_index++] = (uint32_t)(func->args[i].value.ll >> 32); \
+    stack_args[stack_args_index++] = (uxlen_t)(scalar2x >> (XLEN * 8));        \
   } else {                                                                     \
     stack_args_index = ((stack_args_index + 1) &                               \
                         ~1); /* address needs to be aligned to 2XLEN */        \
     assert(stack_args_index < MAX_STACK_ARGS_SIZE);                            \
-    stack_args[stack_args_index++] = (uint32_t)func->args[i].value.ll;         \
+    stack_args[stack_args_index++] = (uxlen_t)scalar2x;                        \
     assert(stack_args_index < MAX_STACK_ARGS_SIZE);                            \
-    stack_args[stack_args_index++] = (uint32_t)(func->args[i].value.ll >> 32); \
+    stack_args[stack_args_index++] = (uxlen_t)(scalar2x >> (XLEN * 8));        \
   }
 
   for (int i = 0; i < func->arg_count; i++) {
+    xlen_t scalar = 0;    // 按整数约定传递的 1XLEN 值
+    dxlen_t scalar2x = 0; // 按整数约定传递的 2XLEN 值
+
     switch (func->args[i].type) {
-    // Integer
+    // Integer (narrower than XLEN: sign-extended to XLEN)
     case ARG_CHAR:
     case ARG_SHORT:
     case ARG_INT:
+      scalar = func->args[i].value.i;
+      goto INTEGER_CALLING_CONVENTION_1XLEN;
     case ARG_LONG:
+      scalar = func->args[i].value.l;
+      goto INTEGER_CALLING_CONVENTION_1XLEN;
     case ARG_POINTER:
-      HANDLE_INTEGER_CALLING_CONVENTION_1XLEN
-      break;
+      scalar = (xlen_t)(uintptr_t)func->args[i].value.p;
+      goto INTEGER_CALLING_CONVENTION_1XLEN;
+#if __riscv_xlen == 32
     case ARG_LONG_LONG:
-      HANDLE_INTEGER_CALLING_CONVENTION_2XLEN
-      break;
+      scalar2x = func->args[i].value.ll;
+      goto INTEGER_CALLING_CONVENTION_2XLEN;
+#else
+    case ARG_LONG_LONG:
+      scalar = func->args[i].value.ll;
+      goto INTEGER_CALLING_CONVENTION_1XLEN;
+    case ARG_INT128:
+      scalar2x = func->args[i].value.i128;
+      goto INTEGER_CALLING_CONVENTION_2XLEN;
+#endif
       // Floating-point
 #if __riscv_float_abi_soft == 1
     case ARG_FLOAT:
+      scalar = func->args[i].value.i;
       goto INTEGER_CALLING_CONVENTION_1XLEN;
     case ARG_DOUBLE:
+#if __riscv_xlen == 32
+      scalar2x = func->args[i].value.ll;
       goto INTEGER_CALLING_CONVENTION_2XLEN;
+#else
+      scalar = func->args[i].value.ll;
+      goto INTEGER_CALLING_CONVENTION_1XLEN;
+#endif
 #elif __riscv_float_abi_single == 1
     case ARG_FLOAT:
       if (fp_argument_regs_index < 8) {
         fp_argument_regs[fp_argument_regs_index++].f = func->args[i].value.f;
-        break;
+        continue;
       }
+      scalar = func->args[i].value.i;
       goto INTEGER_CALLING_CONVENTION_1XLEN;
     case ARG_DOUBLE:
+#if __riscv_xlen == 32
+      scalar2x = func->args[i].value.ll;
       goto INTEGER_CALLING_CONVENTION_2XLEN;
+#else
+      scalar = func->args[i].value.ll;
+      goto INTEGER_CALLING_CONVENTION_1XLEN;
+#endif
 #elif __riscv_float_abi_double == 1
     case ARG_FLOAT:
       if (fp_argument_regs_index < 8) {
@@ -124,21 +230,57 @@ return_value_t universal_caller(func_t *func) {
         fp_argument_regs[fp_argument_regs_index].raw32[1] =
             0xFFFFFFFF; // 1-extended (NaN-boxed) to FLEN bits
         fp_argument_regs_index++;
-        break;
+        continue;
       }
+      scalar = func->args[i].value.i;
       goto INTEGER_CALLING_CONVENTION_1XLEN;
     case ARG_DOUBLE:
       if (fp_argument_regs_index < 8) {
         fp_argument_regs[fp_argument_regs_index++].d = func->args[i].value.d;
-        break;
+        continue;
       }
+#if __riscv_xlen == 32
+      scalar2x = func->args[i].value.ll;
       goto INTEGER_CALLING_CONVENTION_2XLEN;
+#else
+      scalar = func->args[i].value.ll;
+      goto INTEGER_CALLING_CONVENTION_1XLEN;
+#endif
 #else
 #error "unknown abi"
+#endif
+#if UC_HAS_VECTOR
+    case ARG_VECTOR:
+    case ARG_VECTOR_MASK: {
+      const vector_arg_t *v = func->args[i].value.p;
+      int is_mask = func->args[i].type == ARG_VECTOR_MASK;
+      int reg = vector_alloc(&vector_regs_used, v->lmul, is_mask);
+      if (reg < 0) { // 寄存器组用尽: 传递指向数据的指针
+        scalar = (xlen_t)(uintptr_t)v->data;
+        goto INTEGER_CALLING_CONVENTION_1XLEN;
+      }
+      uint32_t bytes = vector_bytes(v, is_mask);
+      assert(bytes <= (is_mask ? 1 : v->lmul) * vlenb);
+      memcpy(vector_stage_reg(vreg_stage, vlenb, reg), v->data, bytes);
+      if (vector_flags == 0 || vector_flags == VECTOR_RET) {
+        vector_vl = v->vl;
+      }
+      if (!is_mask && !vector_vtype_set) {
+        vector_vtype_value = vector_vtype(v);
+        vector_vtype_set = 1;
+      }
+      vector_flags |= VECTOR_ARGS;
+      continue;
+    }
 #endif
     default:
       assert(0); // unknown argument type
+      continue;
     }
+
+    HANDLE_INTEGER_CALLING_CONVENTION_1XLEN
+    continue;
+    HANDLE_INTEGER_CALLING_CONVENTION_2XLEN
   }
 
   if (stack_args_index > 0) {
@@ -146,9 +288,17 @@ return_value_t universal_caller(func_t *func) {
   }
   assert(integar_argument_regs_index <= 8);
   assert(stack_args_size_needed <= (MAX_STACK_ARGS_SIZE * XLEN));
+#if UC_HAS_VECTOR
+  if (!(vector_flags & VECTOR_ARGS) && (vector_flags & VECTOR_RET)) {
+    vector_vl = func->ret_vector->vl;
+  }
+  if (!vector_vtype_set && func->ret_type == RET_VECTOR) {
+    vector_vtype_value = vector_vtype(func->ret_vector);
+  }
+#endif
 
   // Prepare stack arguments if needed
-  uint32_t *sp_addr = NULL;
+  uxlen_t *sp_addr = NULL;
   if (stack_args_index > 0) {
     // Adjust stack - use dynamic size based on arguments
     asm volatile("sub sp, sp, %0\n" ::"r"(stack_args_size_needed)
@@ -164,14 +314,14 @@ return_value_t universal_caller(func_t *func) {
   // Common function call
   asm volatile(
       // Set up integer arguments (a0-a7)
-      "lw a0, %[a0]\n"
-      "lw a1, %[a1]\n"
-      "lw a2, %[a2]\n"
-      "lw a3, %[a3]\n"
-      "lw a4, %[a4]\n"
-      "lw a5, %[a5]\n"
-      "lw a6, %[a6]\n"
-      "lw a7, %[a7]\n"
+      REG_L " a0, %[a0]\n"
+      REG_L " a1, %[a1]\n"
+      REG_L " a2, %[a2]\n"
+      REG_L " a3, %[a3]\n"
+      REG_L " a4, %[a4]\n"
+      REG_L " a5, %[a5]\n"
+      REG_L " a6, %[a6]\n"
+      REG_L " a7, %[a7]\n"
 
 #if __riscv_float_abi_single == 1
       "flw fa0, %[fa0]\n"
@@ -193,18 +343,45 @@ return_value_t universal_caller(func_t *func) {
       "fld fa7, %[fa7]\n"
 #endif
 
+#if UC_HAS_VECTOR
+      // vl/vtype 不属于参数，按第一个向量值设置，供依赖入口 vtype 的汇编函数使用
+      "beqz %[vflags], 1f\n"
+      "vsetvl zero, %[vl], %[vtype]\n"
+      "andi t0, %[vflags], 1\n"
+      "beqz t0, 1f\n"
+      // 整寄存器加载: v0, v8-v15, v16-v23
+      "csrr t0, vlenb\n"
+      "vl1re8.v v0, (%[vstage])\n"
+      "add t1, %[vstage], t0\n"
+      "vl8re8.v v8, (t1)\n"
+      "slli t0, t0, 3\n"
+      "add t1, t1, t0\n"
+      "vl8re8.v v16, (t1)\n"
+      "1:\n"
+#endif
+
       // Call the function
       "jalr ra, %[func], 0\n"
 
       // Capture return values (a0, a1 for integer, fa0 for float/double)
-      "sw a0, %[ret_lo]\n"
-      "sw a1, %[ret_hi]\n"
+      REG_S " a0, %[ret_lo]\n"
+      REG_S " a1, %[ret_hi]\n"
 #if __riscv_float_abi_single == 1
       "fsw fa0, %[ret_fp]\n"
 #elif __riscv_float_abi_double == 1
       "fsd fa0, %[ret_fp]\n"
 #endif
-      : [ret_lo] "=m"(result._raw32[0]), [ret_hi] "=m"(result._raw32[1])
+#if UC_HAS_VECTOR
+      // 向量结果 (v8 寄存器组) 与掩码结果 (v0) 存入暂存区
+      "andi t0, %[vflags], 2\n"
+      "beqz t0, 2f\n"
+      "csrr t0, vlenb\n"
+      "vs1r.v v0, (%[vstage])\n"
+      "add t1, %[vstage], t0\n"
+      "vs8r.v v8, (t1)\n"
+      "2:\n"
+#endif
+      : [ret_lo] "=m"(result.RAW_XLEN[0]), [ret_hi] "=m"(result.RAW_XLEN[1])
 #if __riscv_float_abi_single == 1
                                              ,
         [ret_fp] "=m"(result_fp.f)
@@ -231,6 +408,11 @@ return_value_t universal_caller(func_t *func) {
         [fa2] "m"(fp_argument_regs[2].d), [fa3] "m"(fp_argument_regs[3].d),
         [fa4] "m"(fp_argument_regs[4].d), [fa5] "m"(fp_argument_regs[5].d),
         [fa6] "m"(fp_argument_regs[6].d), [fa7] "m"(fp_argument_regs[7].d)
+#endif
+#if UC_HAS_VECTOR
+        ,
+        [vstage] "r"(vreg_stage), [vflags] "r"(vector_flags),
+        [vl] "r"(vector_vl), [vtype] "r"(vector_vtype_value)
 #endif
       // Clobbered registers
       : "ra", "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7", "t0", "t1", "t2",
@@ -238,6 +420,12 @@ return_value_t universal_caller(func_t *func) {
 #if __riscv_float_abi_single != 1
         "fa0", "fa1", "fa2", "fa3", "fa4", "fa5", "fa6", "fa7", "ft0", "ft1",
         "ft2", "ft3", "ft4", "ft5", "ft6", "ft7", "ft8", "ft9", "ft10", "ft11",
+#endif
+#if UC_HAS_VECTOR
+        "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8", "v9", "v10",
+        "v11", "v12", "v13", "v14", "v15", "v16", "v17", "v18", "v19", "v20",
+        "v21", "v22", "v23", "v24", "v25", "v26", "v27", "v28", "v29", "v30",
+        "v31", "vl", "vtype",
 #endif
         "memory");
 
@@ -247,6 +435,17 @@ return_value_t universal_caller(func_t *func) {
                  : "sp", "memory");
   }
 
+#if UC_HAS_VECTOR
+  if (vector_flags & VECTOR_RET) {
+    vector_arg_t *v = func->ret_vector;
+    int is_mask = func->ret_type == RET_VECTOR_MASK;
+    memcpy(v->data, vector_stage_reg(vreg_stage, vlenb, is_mask ? 0 : 8),
+           vector_bytes(v, is_mask));
+    result.p = v->data;
+    return result;
+  }
+#endif
+
 #if __riscv_float_abi_soft == 1
   return result;
 #elif __riscv_float_abi_single == 1
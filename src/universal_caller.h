@@ -2,7 +2,9 @@
  * universal_caller.h - Header for universal function caller for RISC-V
  *
  * Provides types and functions to call any function with arbitrary signature
- * based on RISC-V calling conventions for rv32g with ilp32 ABI.
+ * based on RISC-V calling conventions for rv32g/rv64g with ilp32 and lp64 ABIs.
+ * The same contract is implemented natively for the x86-64 System V ABI
+ * (see universal_caller_x86_64.c), selected by building with UC_HOST_NATIVE.
  */
 
 #ifndef UNIVERSAL_CALLER_H
@@ -14,6 +16,33 @@
 _Static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
                "Host must be little-endian!");
 
+/**
+ * UC_NATIVE: descriptors hold real pointers of the running machine.
+ * Otherwise the header describes the rv32 wire layout for host-side encoders.
+ * UC_HAS_INT128: 2*XLEN integers (__int128) are passed in register pairs (rv64).
+ * UC_HAS_VECTOR: RVV vector values are passed in v0/v8-v23 (built with the V
+ * extension, make VECTOR=1).
+ */
+#if (__riscv == 1)
+#define UC_NATIVE 1
+#elif defined(UC_HOST_NATIVE) && defined(__x86_64__)
+#define UC_NATIVE 1
+#else
+#define UC_NATIVE 0
+#endif
+
+#if (__riscv == 1) && (__riscv_xlen == 64)
+#define UC_HAS_INT128 1
+#else
+#define UC_HAS_INT128 0
+#endif
+
+#if (__riscv == 1) && defined(__riscv_vector)
+#define UC_HAS_VECTOR 1
+#else
+#define UC_HAS_VECTOR 0
+#endif
+
 /**
  * Argument types supported by the universal caller
  */
@@ -21,11 +50,14 @@ typedef enum : uint32_t {
   ARG_CHAR,      // 32-bit
   ARG_SHORT,     // 32-bit
   ARG_INT,       // 32-bit
-  ARG_LONG,      // 32-bit
+  ARG_LONG,      // 32-bit (64-bit on rv64/x86-64)
   ARG_LONG_LONG, // 64-bit
   ARG_FLOAT,     // 32-bit
   ARG_DOUBLE,    // 64-bit
-  ARG_POINTER    // 32-bit
+  ARG_POINTER,   // 32-bit (64-bit on rv64/x86-64)
+  ARG_INT128,    // 128-bit (rv64 only)
+  ARG_VECTOR,    // vector_arg_t * (UC_HAS_VECTOR only)
+  ARG_VECTOR_MASK // vector_arg_t *, mask (UC_HAS_VECTOR only)
 } arg_type_t;
 
 /**
@@ -36,11 +68,14 @@ typedef enum : uint32_t {
   RET_CHAR,      // 32-bit
   RET_SHORT,     // 32-bit
   RET_INT,       // 32-bit
-  RET_LONG,      // 32-bit
+  RET_LONG,      // 32-bit (64-bit on rv64/x86-64)
   RET_LONG_LONG, // 64-bit
   RET_FLOAT,     // 32-bit
   RET_DOUBLE,    // 64-bit
-  RET_POINTER    // 32-bit
+  RET_POINTER,   // 32-bit (64-bit on rv64/x86-64)
+  RET_INT128,    // 128-bit (rv64 only)
+  RET_VECTOR,    // into func_t.ret_vector, returns its data pointer
+  RET_VECTOR_MASK // into func_t.ret_vector, returns its data pointer
 } ret_type_t;
 
 /**
@@ -55,9 +90,39 @@ typedef union {
   float f;
   double d;
   void *p;
+#if UC_HAS_INT128
+  __int128 i128;
+  uint64_t _raw64[2]; // Raw 64-bit value (for internal use)
+#endif
   uint32_t _raw32[2]; // Raw 32-bit value (for internal use)
 } return_value_t;
 
+/**
+ * RVV vector value: ARG_VECTOR/ARG_VECTOR_MASK arguments point to one through
+ * arg_value_t.p, RET_VECTOR/RET_VECTOR_MASK results are stored in the one at
+ * func_t.ret_vector.
+ *
+ * data holds vl elements of sew bits each; a mask holds one bit per element,
+ * LSB first (the vlm.v layout). lmul is the register group size of the
+ * callee's vector type (fractional LMUL uses 1). Once v8-v23 are used up, a
+ * value is passed by reference and the callee may read lmul * VLENB bytes.
+ */
+typedef struct {
+#if UC_NATIVE
+  void *data; // 元素数据
+#else
+  uint32_t data;
+#endif
+  uint32_t vl;   // 元素个数
+  uint16_t sew;  // 元素位宽: 8/16/32/64 (掩码忽略)
+  uint16_t lmul; // 寄存器组大小: 1/2/4/8 (掩码忽略)
+} vector_arg_t;
+#if UC_NATIVE && (__SIZEOF_POINTER__ == 8)
+_Static_assert(sizeof(vector_arg_t) == 16, "vector_arg_t 大小必须为 16 字节");
+#else
+_Static_assert(sizeof(vector_arg_t) == 12, "vector_arg_t 大小必须为 12 字节");
+#endif
+
 /**
  * Union for passing argument values of different types
  */
@@ -65,17 +130,28 @@ typedef union {
   int32_t c;  // char
   int32_t s;  // short
   int32_t i;  // int
-  int32_t l;  // long
+#if UC_NATIVE
+  long l; // long
+#else
+  int32_t l; // long
+#endif
   int64_t ll; // long long
   float f;    // float
   double d;   // double
-#if (__riscv == 1) && (__riscv_xlen == 32)
+#if UC_NATIVE
   void *p; // pointer
 #else
   uint32_t p;
 #endif
+#if UC_HAS_INT128
+  __int128 i128; // __int128
+#endif
 } arg_value_t;
+#if UC_HAS_INT128
+_Static_assert(sizeof(arg_value_t) == 16, "arg_value_t 大小必须为 16 字节");
+#else
 _Static_assert(sizeof(arg_value_t) == 8, "arg_value_t 大小必须为 8 字节");
+#endif
 _Static_assert(sizeof(float) == 4, "float 大小必须为 4 字节");
 _Static_assert(sizeof(double) == 8, "double 大小必须为 8 字节");
 
@@ -86,32 +162,64 @@ typedef struct {
   arg_type_t type;   // Type of the argument
   arg_value_t value; // Value of the argument
 } arg_t;
+#if UC_HAS_INT128
+_Static_assert(sizeof(arg_t) == 32, "arg_t 大小必须为 32 字节");
+_Static_assert(offsetof(arg_t, type) == 0, "arg_t.type 偏移错误");
+_Static_assert(offsetof(arg_t, value) == 16, "arg_t.value 偏移错误");
+#else
 _Static_assert(sizeof(arg_t) == 16, "arg_t 大小必须为 16 字节");
 _Static_assert(offsetof(arg_t, type) == 0, "arg_t.type 偏移错误");
 _Static_assert(offsetof(arg_t, value) == 8, "arg_t.value 偏移错误");
+#endif
+
+/**
+ * Descriptor flags (func_t.flags)
+ */
+#define FUNC_FLAG_PURE (1u << 0) // 纯函数: 结果只取决于参数值，可被 memo_call() 缓存
 
 /**
  * Structure representing a function to be called with all necessary information
  */
 typedef struct {
-#if (__riscv == 1) && (__riscv_xlen == 32)
+#if UC_NATIVE
   void *func; // Function pointer to call
 #else
   uint32_t func;
 #endif
   ret_type_t ret_type; // Return type of the function
   int32_t arg_count;   // Number of arguments
-#if (__riscv == 1) && (__riscv_xlen == 32)
+#if UC_NATIVE
   arg_t *args; // Array of arguments
 #else
   uint32_t args; // Array of arguments
+#endif
+  uint32_t flags; // FUNC_FLAG_*
+  uint32_t time_budget; // universal_caller_budgeted(): mtime ticks, 0 表示不限制
+#if UC_NATIVE
+  vector_arg_t *ret_vector; // RET_VECTOR/RET_VECTOR_MASK: 结果缓冲区
+#else
+  uint32_t ret_vector;
 #endif
 } func_t;
-_Static_assert(sizeof(func_t) == 16, "func_t 大小必须为 16 字节");
+#if UC_NATIVE && (__SIZEOF_POINTER__ == 8)
+_Static_assert(sizeof(func_t) == 40, "func_t 大小必须为 40 字节");
+_Static_assert(offsetof(func_t, func) == 0, "func_t.func 偏移错误");
+_Static_assert(offsetof(func_t, ret_type) == 8, "func_t.ret_type 偏移错误");
+_Static_assert(offsetof(func_t, arg_count) == 12, "func_t.arg_count 偏移错误");
+_Static_assert(offsetof(func_t, args) == 16, "func_t.args 偏移错误");
+_Static_assert(offsetof(func_t, flags) == 24, "func_t.flags 偏移错误");
+_Static_assert(offsetof(func_t, time_budget) == 28, "func_t.time_budget 偏移错误");
+_Static_assert(offsetof(func_t, ret_vector) == 32, "func_t.ret_vector 偏移错误");
+#else
+_Static_assert(sizeof(func_t) == 28, "func_t 大小必须为 28 字节");
 _Static_assert(offsetof(func_t, func) == 0, "func_t.func 偏移错误");
 _Static_assert(offsetof(func_t, ret_type) == 4, "func_t.ret_type 偏移错误");
 _Static_assert(offsetof(func_t, arg_count) == 8, "func_t.arg_count 偏移错误");
 _Static_assert(offsetof(func_t, args) == 12, "func_t.args 偏移错误");
+_Static_assert(offsetof(func_t, flags) == 16, "func_t.flags 偏移错误");
+_Static_assert(offsetof(func_t, time_budget) == 20, "func_t.time_budget 偏移错误");
+_Static_assert(offsetof(func_t, ret_vector) == 24, "func_t.ret_vector 偏移错误");
+#endif
 
 /**
  * Call a function described by the func_t structure
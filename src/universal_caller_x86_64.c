@@ -0,0 +1,187 @@
+#include "universal_caller.h"
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#if !defined(__x86_64__) || !UC_NATIVE
+#error "universal_caller_x86_64.c requires an x86-64 build with UC_HOST_NATIVE"
+#endif
+
+#define XLEN 8 // 64bits = 8 * 8b
+
+//! (64 * XLEN bits)
+#define MAX_STACK_ARGS_SIZE 64
+
+typedef union {
+  float f;
+  double d;
+  uint32_t raw32[2];
+  uint64_t raw64;
+} fp_reg_t;
+
+/**
+ * 传递给汇编调用桩的调用帧
+ * 通过rbx(callee-saved)整体传入，避免占用参数寄存器
+ */
+typedef struct {
+  uint64_t integar_argument_regs[6]; // rdi, rsi, rdx, rcx, r8, r9
+  fp_reg_t fp_argument_regs[8];      // xmm0-xmm7
+  uint64_t *stack_args;              // 栈参数(按8字节槽)
+  uint64_t stack_args_count;         // 栈参数数量
+  uint64_t fp_argument_count;        // 变参函数需要的 al
+  void *function;                    // 被调用函数
+  uint64_t ret_int;                  // rax
+  fp_reg_t ret_fp;                   // xmm0
+} call_frame_t;
+
+/**
+ * Call a function described by the func_t structure
+ *
+ * x86-64 System V: 整数/指针依次使用 rdi, rsi, rdx, rcx, r8, r9,
+ * float/double 依次使用 xmm0-xmm7，其余参数按从左到右的顺序以8字节槽压栈。
+ * 调用变参函数时 al 需给出所用向量寄存器数量的上界，这里总是设置为实际数量。
+ *
+ * @param func Pointer to the func_t structure containing function information
+ * @return Union containing the return value in the appropriate type field
+ */
+return_value_t universal_caller(func_t *func) {
+  return_value_t result;
+  call_frame_t frame = {0};
+  uint32_t integar_argument_regs_index = 0;
+  uint32_t fp_argument_regs_index = 0;
+  uint64_t stack_args[MAX_STACK_ARGS_SIZE] = {0};
+  uint32_t stack_args_index = 0;
+
+  frame.function = func->func;
+
+#define HANDLE_INTEGER_CALLING_CONVENTION(value)                               \
+  if (integar_argument_regs_index < 6) {                                       \
+    frame.integar_argument_regs[integar_argument_regs_index++] =               \
+        (uint64_t)(value);                                                     \
+  } else {                                                                     \
+    assert(stack_args_index < MAX_STACK_ARGS_SIZE);                            \
+    stack_args[stack_args_index++] = (uint64_t)(value);                        \
+  }
+
+  for (int i = 0; i < func->arg_count; i++) {
+    switch (func->args[i].type) {
+    // Integer (narrow types are sign-extended to the full eightbyte)
+    case ARG_CHAR:
+    case ARG_SHORT:
+    case ARG_INT:
+      HANDLE_INTEGER_CALLING_CONVENTION((int64_t)func->args[i].value.i)
+      break;
+    case ARG_LONG:
+      HANDLE_INTEGER_CALLING_CONVENTION((int64_t)func->args[i].value.l)
+      break;
+    case ARG_LONG_LONG:
+      HANDLE_INTEGER_CALLING_CONVENTION(func->args[i].value.ll)
+      break;
+    case ARG_POINTER:
+      HANDLE_INTEGER_CALLING_CONVENTION((uintptr_t)func->args[i].value.p)
+      break;
+    // Floating-point (SSE class)
+    case ARG_FLOAT:
+      if (fp_argument_regs_index < 8) {
+        frame.fp_argument_regs[fp_argument_regs_index++].f =
+            func->args[i].value.f;
+      } else {
+        fp_reg_t slot = {.raw64 = 0};
+        slot.f = func->args[i].value.f;
+        assert(stack_args_index < MAX_STACK_ARGS_SIZE);
+        stack_args[stack_args_index++] = slot.raw64;
+      }
+      break;
+    case ARG_DOUBLE:
+      if (fp_argument_regs_index < 8) {
+        frame.fp_argument_regs[fp_argument_regs_index++].d =
+            func->args[i].value.d;
+      } else {
+        fp_reg_t slot = {.d = func->args[i].value.d};
+        assert(stack_args_index < MAX_STACK_ARGS_SIZE);
+        stack_args[stack_args_index++] = slot.raw64;
+      }
+      break;
+    default:
+      assert(0); // unknown argument type
+    }
+  }
+#undef HANDLE_INTEGER_CALLING_CONVENTION
+
+  frame.stack_args = stack_args;
+  frame.stack_args_count = stack_args_index;
+  frame.fp_argument_count = fp_argument_regs_index;
+
+  /**
+   * 与rv32实现不同，这里不把rsp列入clobbers，而是在同一段汇编内
+   * 保存/恢复rsp(r12)，因此编译器看到的rsp在汇编前后保持不变。
+   * 先越过128字节red zone，避免call压入的返回地址覆盖编译器放在
+   * red zone中的局部变量；再按16字节对齐栈参数区。
+   */
+  asm volatile(
+      "mov %%rsp, %%r12\n\t"
+      "sub $128, %%rsp\n\t"
+      "mov %c[cnt](%%rbx), %%rcx\n\t"
+      "lea 0(,%%rcx,8), %%rax\n\t"
+      "sub %%rax, %%rsp\n\t"
+      "and $-16, %%rsp\n\t"
+      "mov %c[stk](%%rbx), %%rsi\n\t"
+      "mov %%rsp, %%rdi\n\t"
+      "rep movsq\n\t"
+
+      // Set up floating-point arguments (xmm0-xmm7)
+      "movq %c[fp]+0(%%rbx), %%xmm0\n\t"
+      "movq %c[fp]+8(%%rbx), %%xmm1\n\t"
+      "movq %c[fp]+16(%%rbx), %%xmm2\n\t"
+      "movq %c[fp]+24(%%rbx), %%xmm3\n\t"
+      "movq %c[fp]+32(%%rbx), %%xmm4\n\t"
+      "movq %c[fp]+40(%%rbx), %%xmm5\n\t"
+      "movq %c[fp]+48(%%rbx), %%xmm6\n\t"
+      "movq %c[fp]+56(%%rbx), %%xmm7\n\t"
+
+      // Set up integer arguments (rdi, rsi, rdx, rcx, r8, r9)
+      "mov %c[gp]+0(%%rbx), %%rdi\n\t"
+      "mov %c[gp]+8(%%rbx), %%rsi\n\t"
+      "mov %c[gp]+16(%%rbx), %%rdx\n\t"
+      "mov %c[gp]+24(%%rbx), %%rcx\n\t"
+      "mov %c[gp]+32(%%rbx), %%r8\n\t"
+      "mov %c[gp]+40(%%rbx), %%r9\n\t"
+
+      // Upper bound of vector registers used, for variadic callees
+      "mov %c[nfp](%%rbx), %%rax\n\t"
+
+      // Call the function
+      "call *%c[fn](%%rbx)\n\t"
+
+      // Restore stack, capture return values (rax for integer, xmm0 for fp)
+      "mov %%r12, %%rsp\n\t"
+      "mov %%rax, %c[ret_int](%%rbx)\n\t"
+      "movq %%xmm0, %c[ret_fp](%%rbx)\n\t"
+      :
+      : "b"(&frame), [cnt] "i"(offsetof(call_frame_t, stack_args_count)),
+        [stk] "i"(offsetof(call_frame_t, stack_args)),
+        [fp] "i"(offsetof(call_frame_t, fp_argument_regs)),
+        [gp] "i"(offsetof(call_frame_t, integar_argument_regs)),
+        [nfp] "i"(offsetof(call_frame_t, fp_argument_count)),
+        [fn] "i"(offsetof(call_frame_t, function)),
+        [ret_int] "i"(offsetof(call_frame_t, ret_int)),
+        [ret_fp] "i"(offsetof(call_frame_t, ret_fp))
+      // Clobbered registers
+      : "rax", "rcx", "rdx", "rsi", "rdi", "r8", "r9", "r10", "r11", "r12",
+        "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7", "xmm8",
+        "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15", "cc",
+        "memory");
+
+  switch (func->ret_type) {
+  case RET_FLOAT:
+    result.f = frame.ret_fp.f;
+    break;
+  case RET_DOUBLE:
+    result.d = frame.ret_fp.d;
+    break;
+  default:
+    memcpy(&result, &frame.ret_int, sizeof(frame.ret_int));
+    break;
+  }
+  return result;
+}
@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""Decode tokenised deferred-log blocks (src/dlog.h) from a UART capture.
+
+Usage: dlog_decode.py <image.elf> <uart.log>
+
+Format strings are read from the ELF's non-loaded .dlog_fmt section. "%s"
+arguments are resolved from the loaded sections of the same ELF. Text outside
+dlog blocks (for example regular printf output) is passed through unchanged.
+"""
+
+import re
+import struct
+import sys
+
+from elf_reader import ElfFile
+
+BLOCK_MAGIC = b"DLG1"
+ID_MASK = 0x00FFFFFF
+WORDS_SHIFT = 24
+
+SPEC_RE = re.compile(
+    r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXcsfFeEgGaAp%])")
+
+
+def arg_size(length, conv, xlen):
+    """Size in bytes of a stored argument (printf promotion rules)."""
+    if conv in "fFeEgGaA":
+        return 8
+    if conv in "sp":
+        return xlen
+    if length in ("ll", "j"):
+        return 8
+    if length in ("l", "z", "t"):
+        return xlen
+    return 4
+
+
+def format_record(fmt, payload, elf):
+    out = []
+    pos = 0
+    last = 0
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if width == "*":
+            (width,) = struct.unpack_from("<i", payload, pos)
+            pos += 4
+        if prec == "*":
+            (prec,) = struct.unpack_from("<i", payload, pos)
+            pos += 4
+        size = arg_size(length, conv, elf.xlen)
+        raw = payload[pos:pos + size]
+        pos += size
+        if len(raw) < size:
+            out.append("<missing>")
+            continue
+        unsigned = int.from_bytes(raw, "little")
+        spec = "%" + flags + (str(width) if width is not None else "")
+        if prec is not None:
+            spec += "." + str(prec)
+        if conv in "fFeEgGaA":
+            (value,) = struct.unpack("<d", raw)
+            out.append((spec + ("f" if conv in "aA" else conv)) % value)
+        elif conv == "s":
+            text = elf.read_cstring(unsigned)
+            out.append((spec + "s") % (text if text is not None
+                                       else "<0x%x>" % unsigned))
+        elif conv == "p":
+            out.append((spec + "s") % ("0x%x" % unsigned))
+        elif conv == "c":
+            out.append((spec + "c") % chr(unsigned & 0xFF))
+        elif conv in "di":
+            value = unsigned - (1 << (size * 8)) if unsigned >> (size * 8 - 1) else unsigned
+            out.append((spec + "d") % value)
+        else:
+            out.append((spec + conv) % unsigned)
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+def decode_block(words, elf, fmt_data, fmt_base):
+    lines = []
+    i = 0
+    while i < len(words):
+        header = words[i]
+        nwords = header >> WORDS_SHIFT
+        offset = (header & ID_MASK) - fmt_base
+        payload = struct.pack("<%dI" % nwords, *words[i + 1:i + 1 + nwords])
+        i += 1 + nwords
+        if not 0 <= offset < len(fmt_data):
+            lines.append("<dlog: bad format id 0x%06x>\n" % (header & ID_MASK))
+            continue
+        end = fmt_data.index(b"\0", offset)
+        fmt = fmt_data[offset:end].decode("utf-8", "replace")
+        lines.append(format_record(fmt, payload, elf))
+    return "".join(lines)
+
+
+def decode_stream(data, elf):
+    sec = elf.section(".dlog_fmt")
+    fmt_data = elf.section_data(sec) if sec else b""
+    fmt_base = (sec.addr & ID_MASK) if sec else 0
+    out = []
+    pos = 0
+    while True:
+        start = data.find(BLOCK_MAGIC, pos)
+        if start < 0:
+            out.append(data[pos:].decode("utf-8", "replace"))
+            break
+        out.append(data[pos:start].decode("utf-8", "replace"))
+        count, dropped = struct.unpack_from("<II", data, start + 4)
+        body = start + 12
+        words = struct.unpack_from("<%dI" % count, data, body)
+        out.append(decode_block(words, elf, fmt_data, fmt_base))
+        if dropped:
+            out.append("<dlog: %d records dropped>\n" % dropped)
+        pos = body + count * 4
+    return "".join(out)
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write(__doc__)
+        return 2
+    elf = ElfFile(argv[1])
+    with open(argv[2], "rb") as f:
+        data = f.read()
+    sys.stdout.write(decode_stream(data, elf))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
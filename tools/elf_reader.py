@@ -0,0 +1,114 @@
+"""Minimal ELF32/ELF64 little-endian reader for the host-side tools.
+
+Only what the tools need: section headers and data, and the symbol table.
+No third-party dependencies.
+"""
+
+import struct
+
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+STT_FUNC = 2
+
+
+class Section:
+    def __init__(self, name, sh_type, flags, addr, offset, size, link, entsize):
+        self.name = name
+        self.type = sh_type
+        self.flags = flags
+        self.addr = addr
+        self.offset = offset
+        self.size = size
+        self.link = link
+        self.entsize = entsize
+
+
+class Symbol:
+    def __init__(self, name, value, size, sym_type):
+        self.name = name
+        self.value = value
+        self.size = size
+        self.type = sym_type
+
+
+class ElfFile:
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError("%s: not an ELF file" % path)
+        if self.data[5] != 1:
+            raise ValueError("%s: only little-endian ELF is supported" % path)
+        self.is64 = self.data[4] == 2
+        self.xlen = 8 if self.is64 else 4
+        if self.is64:
+            (self.machine,) = struct.unpack_from("<H", self.data, 18)
+            shoff, = struct.unpack_from("<Q", self.data, 40)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 58)
+        else:
+            (self.machine,) = struct.unpack_from("<H", self.data, 18)
+            shoff, = struct.unpack_from("<I", self.data, 32)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 46)
+        raw = []
+        for i in range(shnum):
+            off = shoff + i * shentsize
+            if self.is64:
+                (name, sh_type, flags, addr, offset, size, link, _info, _align,
+                 entsize) = struct.unpack_from("<IIQQQQIIQQ", self.data, off)
+            else:
+                (name, sh_type, flags, addr, offset, size, link, _info, _align,
+                 entsize) = struct.unpack_from("<IIIIIIIIII", self.data, off)
+            raw.append((name, sh_type, flags, addr, offset, size, link, entsize))
+        strtab = raw[shstrndx]
+        self.sections = [
+            Section(self._cstr(strtab[4] + r[0]), *r[1:]) for r in raw
+        ]
+
+    def _cstr(self, offset):
+        end = self.data.index(b"\0", offset)
+        return self.data[offset:end].decode("utf-8", "replace")
+
+    def section(self, name):
+        for sec in self.sections:
+            if sec.name == name:
+                return sec
+        return None
+
+    def section_data(self, sec):
+        if sec.type == SHT_NOBITS:
+            return bytes(sec.size)
+        return self.data[sec.offset:sec.offset + sec.size]
+
+    def read_cstring(self, addr):
+        """Read a NUL-terminated string at a runtime address, or None."""
+        for sec in self.sections:
+            if (sec.flags & SHF_ALLOC and sec.type != SHT_NOBITS
+                    and sec.addr <= addr < sec.addr + sec.size):
+                start = sec.offset + addr - sec.addr
+                end = self.data.find(b"\0", start, sec.offset + sec.size)
+                if end < 0:
+                    return None
+                return self.data[start:end].decode("utf-8", "replace")
+        return None
+
+    def symbols(self):
+        """All named symbols from .symtab."""
+        symtab = next((s for s in self.sections if s.type == SHT_SYMTAB), None)
+        if symtab is None:
+            return []
+        strtab = self.sections[symtab.link]
+        result = []
+        entsize = symtab.entsize or (24 if self.is64 else 16)
+        for off in range(symtab.offset, symtab.offset + symtab.size, entsize):
+            if self.is64:
+                name, info, _other, _shndx, value, size = struct.unpack_from(
+                    "<IBBHQQ", self.data, off)
+            else:
+                name, value, size, info, _other, _shndx = struct.unpack_from(
+                    "<IIIBBH", self.data, off)
+            if name == 0:
+                continue
+            result.append(Symbol(self._cstr(strtab.offset + name), value, size,
+                                 info & 0xF))
+        return result
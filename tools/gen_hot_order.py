@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Generate the hot-function linker ordering file from call counts.
+
+Usage: gen_hot_order.py <instrumented.elf> <uart.log> [-o hot_order.ld]
+                        [--coverage F] [--min-calls N] [--report image.elf]
+
+Reads the CALLS-BEGIN/CALLS/CALLS-END lines (src/callcount.h) from a UART
+capture of an image built with CALLCOUNT=1 and maps the function addresses to
+names with that image's symbols. The most called functions, enough to cover
+--coverage of all counted calls, are written as input section patterns for the
+INCLUDE in src/link.ld, hottest first. universal_caller always comes first: it
+is on the path of every dispatched call.
+
+--report prints the footprint of the hot set in another image (built with the
+same sources, not instrumented): total size, the address span from the first
+to the last hot function, and the 64-byte cache lines and 4 KB pages it
+touches. Run it before and after relinking with the ordering file to see the
+effect (make pgo does both).
+"""
+
+import argparse
+import sys
+
+from elf_reader import ElfFile, STT_FUNC
+from prof_report import Symbolizer
+
+ALWAYS_HOT = ["universal_caller"]
+LINE_SIZE = 64
+PAGE_SIZE = 4096
+
+
+def parse_counts(lines):
+    """Yield (address, count) pairs."""
+    inside = False
+    for line in lines:
+        line = line.strip()
+        if line.startswith("CALLS-BEGIN"):
+            inside = True
+            sys.stderr.write(line + "\n")
+        elif line.startswith("CALLS-END"):
+            inside = False
+        elif inside and line.startswith("CALLS "):
+            _, addr, count = line.split()
+            yield int(addr, 16), int(count)
+
+
+def select_hot(counts, coverage, min_calls):
+    """Most called functions first, until coverage of all calls is reached."""
+    total = sum(counts.values())
+    hot, covered = [], 0
+    for name, count in sorted(counts.items(), key=lambda kv: (-kv[1], kv[0])):
+        if count < min_calls or (total and covered >= coverage * total):
+            break
+        hot.append((name, count))
+        covered += count
+    return hot, covered, total
+
+
+def write_order(out, hot):
+    out.write("/* Generated by tools/gen_hot_order.py (make pgo). Do not edit. */\n")
+    for name in ALWAYS_HOT:
+        out.write("*(.text.%s)\n" % name)
+    for name, count in hot:
+        if name not in ALWAYS_HOT:
+            out.write("*(.text.%s) /* %d calls */\n" % (name, count))
+
+
+def footprint(elf_path, names):
+    funcs = [(s.value, s.size) for s in ElfFile(elf_path).symbols()
+             if s.type == STT_FUNC and s.value and s.name in names]
+    if not funcs:
+        return None
+    lines, pages = set(), set()
+    for start, size in funcs:
+        end = start + max(size, 1)
+        lines.update(range(start // LINE_SIZE, (end - 1) // LINE_SIZE + 1))
+        pages.update(range(start // PAGE_SIZE, (end - 1) // PAGE_SIZE + 1))
+    return {
+        "functions": len(funcs),
+        "bytes": sum(size for _, size in funcs),
+        "span": max(s + n for s, n in funcs) - min(s for s, _ in funcs),
+        "lines": len(lines),
+        "pages": len(pages),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="image built with CALLCOUNT=1")
+    parser.add_argument("log")
+    parser.add_argument("-o", "--output", help="output file (default: stdout)")
+    parser.add_argument("--coverage", type=float, default=0.99,
+                        help="fraction of all counted calls the hot set "
+                        "covers (default: 0.99)")
+    parser.add_argument("--min-calls", type=int, default=2,
+                        help="leave out functions called fewer times")
+    parser.add_argument("--report", metavar="ELF",
+                        help="print the hot set footprint in this image")
+    args = parser.parse_args()
+
+    sym = Symbolizer(ElfFile(args.elf))
+    counts = {}
+    with open(args.log, "r", encoding="utf-8", errors="replace") as f:
+        for addr, count in parse_counts(f):
+            name = sym.lookup(addr)
+            if not name.startswith("0x"):
+                counts[name] = counts.get(name, 0) + count
+    if not counts:
+        print("no call counts (was the image built with CALLCOUNT=1?)")
+        return 1
+
+    hot, covered, total = select_hot(counts, args.coverage, args.min_calls)
+    sys.stderr.write("%d of %d functions cover %d of %d calls\n"
+                     % (len(hot), len(counts), covered, total))
+    if args.output:
+        with open(args.output, "w") as f:
+            write_order(f, hot)
+    else:
+        write_order(sys.stdout, hot)
+
+    if args.report:
+        names = set(ALWAYS_HOT) | {name for name, _ in hot}
+        fp = footprint(args.report, names)
+        if fp is None:
+            print("%s: no hot functions found" % args.report)
+        else:
+            print("%s: hot set %d functions, %d bytes, span %d bytes, "
+                  "%d cache lines (%d B), %d pages (%d KB)"
+                  % (args.report, fp["functions"], fp["bytes"], fp["span"],
+                     fp["lines"], LINE_SIZE, fp["pages"], PAGE_SIZE // 1024))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+"""Generate random signatures for the signature-space test and benchmark.
+
+Usage: gen_sigspace.py --platform rv32|rv64|x86_64 [--seed N] [--count N]
+                       [-o cases.c]
+
+Writes a C file for sigspace/driver.c (see sigspace/sigspace.h). Each
+signature gets a noipa callee, a direct call of it with fixed random argument
+values, and a func_t descriptor holding the same values. The same seed,
+count and platform always produce the same file.
+
+Every signature is put in a class based on where its arguments go under the
+platform ABI (ilp32d/lp64d or System V): "int" and "fp" mean register
+arguments, "stack" means at least one stack slot, "fp2int" means an FP
+argument moved to integer registers once fa0-fa7 were full, and "split" means
+a 2*XLEN value split between a7 and the stack.
+"""
+
+import argparse
+import random
+import struct
+import sys
+
+MAX_ARGS = 24  # universal_caller.c: MAX_STACK_ARGS_SIZE 限制栈参数数量
+
+# name: (C 类型, arg_type_t, arg_value_t 字段, ret_type_t, return_value_t 字段)
+TYPES = {
+    "char": ("char", "ARG_CHAR", "c", "RET_CHAR", "c"),
+    "short": ("short", "ARG_SHORT", "s", "RET_SHORT", "s"),
+    "int": ("int32_t", "ARG_INT", "i", "RET_INT", "i"),
+    "long": ("long", "ARG_LONG", "l", "RET_LONG", "l"),
+    "long long": ("long long", "ARG_LONG_LONG", "ll", "RET_LONG_LONG", "ll"),
+    "float": ("float", "ARG_FLOAT", "f", "RET_FLOAT", "f"),
+    "double": ("double", "ARG_DOUBLE", "d", "RET_DOUBLE", "d"),
+    "pointer": ("void *", "ARG_POINTER", "p", "RET_POINTER", "p"),
+    "int128": ("__int128", "ARG_INT128", "i128", "RET_INT128", "i128"),
+}
+INT_TYPES = ["char", "short", "int", "long", "long long", "pointer"]
+FP_TYPES = ["float", "double"]
+
+
+def platform_types(platform):
+    return INT_TYPES + FP_TYPES + (["int128"] if platform == "rv64" else [])
+
+
+def classify(platform, args):
+    """Where the arguments go: a class name such as "int+fp+stack"."""
+    flags = set()
+    if platform == "x86_64":
+        gpr = sse = 0
+        for t in args:
+            if t in FP_TYPES:
+                if sse < 8:
+                    sse += 1
+                    flags.add("fp")
+                else:
+                    flags.add("stack")
+            elif gpr < 6:
+                gpr += 1
+                flags.add("int")
+            else:
+                flags.add("stack")
+    else:
+        xlen = 4 if platform == "rv32" else 8
+        ireg = freg = 0
+        for t in args:
+            if t in FP_TYPES and freg < 8:
+                freg += 1
+                flags.add("fp")
+                continue
+            if t in FP_TYPES:
+                flags.add("fp2int")
+            size = {"long long": 8, "double": 8, "int128": 16}.get(t, xlen)
+            if size <= xlen:
+                if ireg < 8:
+                    ireg += 1
+                    flags.add("int")
+                else:
+                    flags.add("stack")
+            elif ireg <= 6:
+                ireg += 2
+                flags.add("int")
+            elif ireg == 7:
+                ireg += 1
+                flags.update(("int", "split"))
+            else:
+                flags.add("stack")
+    order = ["int", "fp", "fp2int", "split", "stack"]
+    return "+".join(f for f in order if f in flags) or "none"
+
+
+def literal(rng, t):
+    """Random argument value as a C expression of type t."""
+    if t == "char":  # 0..127: char 在 RISC-V 上无符号，在 x86-64 上有符号
+        return "%d" % rng.randint(0, 127)
+    if t == "short":
+        return "%d" % rng.randint(-32768, 32767)
+    if t == "int":
+        return "(int32_t)0x%08XU" % rng.getrandbits(32)
+    if t == "long":
+        return "(long)0x%016XULL" % rng.getrandbits(64)
+    if t == "long long":
+        return "(long long)0x%016XULL" % rng.getrandbits(64)
+    if t == "pointer":
+        return "(void *)(uintptr_t)0x%016XULL" % rng.getrandbits(64)
+    if t == "int128":
+        return ("(__int128)(((unsigned __int128)0x%016XULL << 64) | 0x%016XULL)"
+                % (rng.getrandbits(64), rng.getrandbits(64)))
+    special = [0.0, -0.0, 1.0, -1.5, 1e-30, 3.0e38]
+    if rng.random() < 0.1:
+        value = rng.choice(special)
+    else:
+        value = rng.uniform(-1e6, 1e6)
+    if t == "float":
+        value = struct.unpack("<f", struct.pack("<f", value))[0]
+        return "%sf" % value.hex()
+    return value.hex()
+
+
+def mix_expr(t, name):
+    if t == "float":
+        return ["sigspace_float_bits(%s)" % name]
+    if t == "double":
+        return ["sigspace_double_bits(%s)" % name]
+    if t == "pointer":
+        return ["(uintptr_t)%s" % name]
+    if t == "int128":
+        return ["(uint64_t)%s" % name, "(uint64_t)(%s >> 64)" % name]
+    return ["(uint64_t)%s" % name]
+
+
+def return_expr(t):
+    if t == "float":
+        return "sigspace_make_float(h)"
+    if t == "double":
+        return "sigspace_make_double(h)"
+    if t == "pointer":
+        return "(void *)(uintptr_t)h"
+    if t == "int128":
+        return "((__int128)h << 64) | (h ^ 0x5555555555555555ull)"
+    return "(%s)h" % TYPES[t][0]
+
+
+def random_signature(rng, types):
+    # 偏向整数或浮点的签名更容易触及寄存器用尽后的路径
+    regime = rng.random()
+    if regime < 0.3:
+        pool = [t for t in types if t not in FP_TYPES]
+    elif regime < 0.6:
+        pool = FP_TYPES * 3 + ["long long", "int"]
+    else:
+        pool = types
+    argc = min(MAX_ARGS, int(rng.triangular(0, MAX_ARGS + 1, 9)))
+    args = [rng.choice(pool) for _ in range(argc)]
+    ret = rng.choice(["void"] + types)
+    return ret, args
+
+
+def generate(platform, seed, count):
+    rng = random.Random(seed)
+    types = platform_types(platform)
+    classes = []
+    out = [
+        "// Generated by tools/gen_sigspace.py --platform %s --seed %d "
+        "--count %d" % (platform, seed, count),
+        "// Do not edit.",
+        '#include "sigspace.h"',
+        "",
+    ]
+    table = []
+    for n in range(count):
+        ret, args = random_signature(rng, types)
+        values = [literal(rng, t) for t in args]
+        cls = classify(platform, args)
+        if cls not in classes:
+            classes.append(cls)
+        ret_c = "void" if ret == "void" else TYPES[ret][0]
+        params = ", ".join("%s a%d" % (TYPES[t][0], i)
+                           for i, t in enumerate(args)) or "void"
+
+        out.append("__attribute__((noipa)) static %s sig_%d(%s) {"
+                   % (ret_c, n, params))
+        out.append("  uint64_t h = 0x%016XULL;" % rng.getrandbits(64))
+        for i, t in enumerate(args):
+            for expr in mix_expr(t, "a%d" % i):
+                out.append("  h = sigspace_mix(h, %s);" % expr)
+        out.append("  sigspace_sink = h;")
+        if ret != "void":
+            out.append("  return %s;" % return_expr(ret))
+        out.append("}")
+
+        call = "sig_%d(%s)" % (n, ", ".join(values))
+        out.append("static void sig_%d_direct(return_value_t *ret) {" % n)
+        if ret == "void":
+            out.append("  (void)ret;")
+            out.append("  %s;" % call)
+        else:
+            out.append("  ret->%s = %s;" % (TYPES[ret][4], call))
+        out.append("}")
+        if args:
+            out.append("static arg_t sig_%d_args[] = {" % n)
+            for t, v in zip(args, values):
+                out.append("    {%s, {.%s = %s}}," % (TYPES[t][1], TYPES[t][2], v))
+            out.append("};")
+        out.append("")
+
+        signature = "%s(%s)" % (ret, ", ".join(args))
+        table.append((signature, classes.index(cls), ret, len(args), n))
+
+    out.append("sigspace_case_t sigspace_cases[] = {")
+    for signature, cls, ret, argc, n in table:
+        ret_type = "RET_VOID" if ret == "void" else TYPES[ret][3]
+        out.append('    {"%s", %d,' % (signature, cls))
+        out.append("     {.func = sig_%d, .ret_type = %s, .arg_count = %d, "
+                   ".args = %s}," % (n, ret_type, argc,
+                                     "sig_%d_args" % n if argc else "NULL"))
+        out.append("     sig_%d_direct}," % n)
+    out.append("};")
+    out.append("const uint32_t sigspace_case_count = %d;" % count)
+    out.append("const char *const sigspace_classes[] = {%s};"
+               % ", ".join('"%s"' % c for c in classes))
+    out.append("const uint32_t sigspace_class_count = %d;" % len(classes))
+    out.append("const uint32_t sigspace_seed = %d;" % seed)
+    return "\n".join(out) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--platform", choices=("rv32", "rv64", "x86_64"),
+                        required=True)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--count", type=int, default=1000)
+    parser.add_argument("-o", "--output", help="output file (default: stdout)")
+    args = parser.parse_args()
+    if args.count < 1:
+        raise SystemExit("--count must be at least 1")
+
+    text = generate(args.platform, args.seed, args.count)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Map sampling-profiler output (src/profiler.h) to symbols.
+
+Usage: prof_report.py <image.elf> <uart.log> [--top N]
+
+Reads the PROF-BEGIN/PROF/PROF-END lines from a UART capture. It prints a flat
+profile (samples whose pc is in the function) and an inclusive profile (samples
+with the function anywhere in the recorded chain).
+"""
+
+import argparse
+import bisect
+import collections
+import sys
+
+from elf_reader import ElfFile, STT_FUNC
+
+
+class Symbolizer:
+    def __init__(self, elf):
+        funcs = sorted((s.value, s.size, s.name) for s in elf.symbols()
+                       if s.type == STT_FUNC and s.value)
+        self.starts = [f[0] for f in funcs]
+        self.funcs = funcs
+
+    def lookup(self, addr):
+        i = bisect.bisect_right(self.starts, addr) - 1
+        if i < 0:
+            return "0x%x" % addr
+        start, size, name = self.funcs[i]
+        if size and addr >= start + size:
+            return "0x%x" % addr
+        return name
+
+
+def parse_samples(lines):
+    """Yield lists of addresses, one per sample."""
+    inside = False
+    for line in lines:
+        line = line.strip()
+        if line.startswith("PROF-BEGIN"):
+            inside = True
+            sys.stderr.write(line + "\n")
+        elif line.startswith("PROF-END"):
+            inside = False
+        elif inside and line.startswith("PROF "):
+            addrs = [int(tok, 16) for tok in line.split()[1:]]
+            yield [a for a in addrs if a]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf")
+    parser.add_argument("log")
+    parser.add_argument("--top", type=int, default=20)
+    args = parser.parse_args()
+
+    sym = Symbolizer(ElfFile(args.elf))
+    with open(args.log, "r", encoding="utf-8", errors="replace") as f:
+        samples = list(parse_samples(f))
+    if not samples:
+        print("no samples")
+        return 1
+
+    flat = collections.Counter()
+    inclusive = collections.Counter()
+    for chain in samples:
+        names = [sym.lookup(a) for a in chain]
+        if names:
+            flat[names[0]] += 1
+        for name in set(names):
+            inclusive[name] += 1
+
+    total = len(samples)
+    print("%d samples" % total)
+    print("\n%-8s %-7s %s" % ("flat", "%", "function"))
+    for name, count in flat.most_common(args.top):
+        print("%-8d %6.2f%% %s" % (count, 100.0 * count / total, name))
+    print("\n%-8s %-7s %s" % ("incl", "%", "function"))
+    for name, count in inclusive.most_common(args.top):
+        print("%-8d %6.2f%% %s" % (count, 100.0 * count / total, name))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,520 @@
+#!/usr/bin/env python3
+"""End-to-end call throughput benchmark against the serial call server.
+
+Usage: uc_bench.py <image.elf> [--mix name:weight,...] [--batch N]
+                   [--chain | --round-trips] [--payload BYTES]
+                   [--requests N] [--format csv|json]
+
+Boots the image (built with RPC=1, see src/rpc.h) in QEMU with the UART on
+stdio, or runs --cmd instead. It fetches the function table with LIST, then
+streams CALL requests drawn from the weighted mix. The reported numbers cover
+host encoding, the serial transport, target dispatch and result return:
+calls/s, request latency percentiles and bytes per call.
+
+Argument values are random, from --seed. A POINTER argument carries --payload
+random bytes, and an INT argument right after it receives their length. Results
+of known test functions are checked, and mismatches are counted as errors.
+
+--chain makes each batch a dependent pipeline: every call takes the previous
+call's result in its first argument of the same kind (integer or
+floating-point). The pipeline is sent as one CHAIN request, and only the final
+result comes back. --round-trips sends the same pipeline as one CALL request
+per call, with the host forwarding each result, as a client without chains
+must. Comparing the two shows the saved round trips.
+"""
+
+import argparse
+import csv
+import json
+import math
+import os
+import random
+import shlex
+import struct
+import subprocess
+import sys
+import time
+
+REQUEST_MAGIC = 0xA5
+REPLY_MAGIC = 0x5A
+OP_PING, OP_LIST, OP_CALL, OP_QUIT, OP_CHAIN = 0, 1, 2, 3, 4
+MAX_FRAME = 4096
+# rpc_serve() 的问候帧 (其后一个字节为 XLEN)，启动输出中不会出现
+HELLO = struct.pack("<BBH", REPLY_MAGIC, 0, 6) + b"UCRPC"
+
+# src/chain.h 中的操作码与操作数来源
+CHAIN_CALL, CHAIN_SET, CHAIN_ADD, CHAIN_JMP, CHAIN_JZ, CHAIN_JNZ, CHAIN_JLT, \
+    CHAIN_EMIT, CHAIN_HALT = range(9)
+SRC_CONST, SRC_RESULT, SRC_SCRATCH = range(3)
+MAX_CHAIN_INSNS = 64  # src/rpc.h: RPC_MAX_CHAIN_INSNS
+
+# universal_caller.h 中 arg_type_t / ret_type_t 的取值
+ARG_CHAR, ARG_SHORT, ARG_INT, ARG_LONG, ARG_LONG_LONG, ARG_FLOAT, \
+    ARG_DOUBLE, ARG_POINTER = range(8)
+RET_VOID, RET_CHAR, RET_SHORT, RET_INT, RET_LONG, RET_LONG_LONG, \
+    RET_FLOAT, RET_DOUBLE, RET_POINTER = range(9)
+
+ARG_FORMAT = {ARG_CHAR: "<i", ARG_SHORT: "<i", ARG_INT: "<i", ARG_LONG: "<q",
+              ARG_LONG_LONG: "<q", ARG_FLOAT: "<f", ARG_DOUBLE: "<d"}
+RET_FORMAT = {RET_CHAR: "<i", RET_SHORT: "<i", RET_INT: "<i", RET_LONG: "<q",
+              RET_LONG_LONG: "<q", RET_FLOAT: "<f", RET_DOUBLE: "<d",
+              RET_POINTER: "<q"}
+
+
+def fnv1a(data):
+    h = 0x811C9DC5
+    for b in data:
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return struct.unpack("<i", struct.pack("<I", h))[0]
+
+
+def i32(x):
+    return struct.unpack("<i", struct.pack("<I", x & 0xFFFFFFFF))[0]
+
+
+def i64(x):
+    return struct.unpack("<q", struct.pack("<Q", x & 0xFFFFFFFFFFFFFFFF))[0]
+
+
+def f32(x):
+    return struct.unpack("<f", struct.pack("<f", x))[0]
+
+
+# 已知测试函数的期望结果 (src/test_funcs.txt, src/main.c)
+EXPECTED = {
+    "test_no_args": lambda a: 42,
+    "test_reg_args": lambda a: i32(sum(a)),
+    "test_stack_args": lambda a: i32(sum(a)),
+    "test_many_args": lambda a: i32(sum(a)),
+    "test_float_args": lambda a: f32(a[0] + a[1]) + a[2] + a[3],
+    "test_many_doubles": lambda a: sum(a),
+    "test_long_args": lambda a: a[0] - a[1],
+    "bench_checksum": lambda a: fnv1a(a[0]),
+}
+
+
+class Target:
+    """Frame transport over a child process's stdin/stdout."""
+
+    def __init__(self, argv):
+        self.proc = subprocess.Popen(argv, stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE, bufsize=0)
+        self.tx_bytes = 0
+        self.rx_bytes = 0
+
+    def read_exact(self, n):
+        data = b""
+        while len(data) < n:
+            chunk = self.proc.stdout.read(n - len(data))
+            if not chunk:
+                raise RuntimeError("target closed the connection")
+            data += chunk
+        self.rx_bytes += n
+        return data
+
+    def wait_hello(self):
+        """Skip the boot output up to the hello frame; return the XLEN."""
+        boot = bytearray()
+        while not boot.endswith(HELLO):
+            boot += self.read_exact(1)
+        text = bytes(boot[:-len(HELLO)])
+        if text.strip():
+            sys.stderr.write(text.decode("utf-8", errors="replace"))
+        return self.read_exact(1)[0]
+
+    def read_frame(self):
+        # 问候帧之后串口上只有应答帧，其他字节说明已失去同步
+        magic = self.read_exact(1)[0]
+        if magic != REPLY_MAGIC:
+            raise RuntimeError("expected a reply frame, got byte 0x%02X"
+                               % magic)
+        status, length = struct.unpack("<BH", self.read_exact(3))
+        return status, self.read_exact(length)
+
+    def request(self, op, payload=b""):
+        if len(payload) > MAX_FRAME:
+            raise RuntimeError("request of %d bytes exceeds the %d byte frame"
+                               % (len(payload), MAX_FRAME))
+        frame = struct.pack("<BBH", REQUEST_MAGIC, op, len(payload)) + payload
+        self.proc.stdin.write(frame)
+        self.tx_bytes += len(frame)
+        status, reply = self.read_frame()
+        if status != 0:
+            raise RuntimeError("target returned status %d for op %d"
+                               % (status, op))
+        return reply
+
+    def close(self):
+        try:
+            self.request(OP_QUIT)
+        except (RuntimeError, OSError):
+            pass
+        self.proc.kill()
+        self.proc.wait()
+
+
+def parse_list(reply):
+    (count,), pos = struct.unpack_from("<H", reply), 2
+    table = []
+    for _ in range(count):
+        ret, argc = reply[pos], reply[pos + 1]
+        types = list(reply[pos + 2:pos + 2 + argc])
+        pos += 2 + argc
+        name_len = reply[pos]
+        name = reply[pos + 1:pos + 1 + name_len].decode()
+        pos += 1 + name_len
+        table.append({"name": name, "ret": ret, "types": types})
+    return table
+
+
+def make_args(rng, types, payload, xlen):
+    values = []
+    for i, t in enumerate(types):
+        if t == ARG_POINTER:
+            values.append(bytes(rng.getrandbits(8) for _ in range(payload)))
+        elif t == ARG_INT and i > 0 and types[i - 1] == ARG_POINTER:
+            values.append(len(values[-1]))
+        elif t in (ARG_CHAR, ARG_SHORT, ARG_INT):
+            values.append(rng.randint(-1000, 1000))
+        elif t == ARG_LONG:  # long 与 XLEN 同宽
+            bits = 8 * xlen
+            values.append(rng.randint(-(1 << (bits - 1)), (1 << (bits - 1)) - 1))
+        elif t == ARG_LONG_LONG:
+            values.append(rng.randint(-(1 << 31), (1 << 31) - 1))
+        elif t == ARG_FLOAT:
+            values.append(f32(rng.uniform(-100.0, 100.0)))
+        elif t == ARG_DOUBLE:
+            values.append(rng.uniform(-1000.0, 1000.0))
+        else:
+            raise RuntimeError("argument type %d is not supported" % t)
+    return values
+
+
+def encode_call(func_id, types, values):
+    out = [bytes([func_id])]
+    for t, v in zip(types, values):
+        if t == ARG_POINTER:
+            out.append(struct.pack("<H", len(v)) + v)
+        else:
+            out.append(struct.pack(ARG_FORMAT[t], v))
+    return b"".join(out)
+
+
+def expected_result(entry, values, xlen):
+    """Expected return value, or None for functions without a model."""
+    expect = EXPECTED.get(entry["name"])
+    if expect is None:
+        return None
+    want = expect(values)
+    if entry["ret"] == RET_LONG:  # 目标端 long 运算按 XLEN 回绕
+        want = i32(want) if xlen == 4 else i64(want)
+    return want
+
+
+def matches(result, want):
+    if want is None:
+        return True
+    if isinstance(want, float):
+        return abs(result - want) <= 1e-4 * max(1.0, abs(want))
+    return result == want
+
+
+def check(entry, values, result, xlen):
+    return matches(result, expected_result(entry, values, xlen))
+
+
+# 链程序编码 (src/rpc.h 中的 RPC_OP_CHAIN)
+def operand_const(t, value):
+    """Constant operand for an argument of type t."""
+    if t == ARG_POINTER:
+        return struct.pack("<BBH", SRC_CONST, RET_POINTER, len(value)) + value
+    if t in (ARG_FLOAT, ARG_DOUBLE):
+        return struct.pack("<BBd", SRC_CONST, RET_DOUBLE, value)
+    return struct.pack("<BBq", SRC_CONST, RET_LONG_LONG, value)
+
+
+def operand_result(slot):
+    return struct.pack("<BB", SRC_RESULT, slot)
+
+
+def operand_scratch(slot):
+    return struct.pack("<BB", SRC_SCRATCH, slot)
+
+
+def chain_insn(op, dst=0, target=0, func_id=None, operands=()):
+    """One instruction; CALL takes func_id and one operand per argument."""
+    out = struct.pack("<BBH", op, dst, target)
+    if op == CHAIN_CALL:
+        out += bytes([func_id])
+    return out + b"".join(operands)
+
+
+def encode_chain(insns, max_steps=0):
+    return struct.pack("<HI", len(insns), max_steps) + b"".join(insns)
+
+
+def parse_chain_reply(reply):
+    """(chain status, steps, calls, emitted values)"""
+    status, steps, calls, count = struct.unpack_from("<BIIB", reply)
+    pos, outputs = 10, []
+    for _ in range(count):
+        t = reply[pos]
+        fmt = "<d" if t in (RET_FLOAT, RET_DOUBLE) else "<q"
+        outputs.append(struct.unpack_from(fmt, reply, pos + 1)[0])
+        pos += 9
+    return status, steps, calls, outputs
+
+
+# 依赖调用链: 每个调用的第一个同类参数 (整数或浮点) 取上一个调用的结果
+INT_ARGS = (ARG_INT, ARG_LONG, ARG_LONG_LONG)
+FP_ARGS = (ARG_FLOAT, ARG_DOUBLE)
+INT_RETS = (RET_CHAR, RET_SHORT, RET_INT, RET_LONG, RET_LONG_LONG)
+FP_RETS = (RET_FLOAT, RET_DOUBLE)
+
+
+def forward_slot(types, prev_ret):
+    kinds = INT_ARGS if prev_ret in INT_RETS else \
+        FP_ARGS if prev_ret in FP_RETS else ()
+    for i, t in enumerate(types):
+        if t in kinds and not (i > 0 and types[i - 1] == ARG_POINTER):
+            return i
+    return None
+
+
+def convert(value, t, xlen):
+    """Value passed to an argument of type t (C assignment on the target)."""
+    if t == ARG_INT or (t == ARG_LONG and xlen == 4):
+        return i32(int(value))
+    if t in (ARG_LONG, ARG_LONG_LONG):
+        return i64(int(value))
+    if t == ARG_FLOAT:
+        return f32(value)
+    return float(value)
+
+
+def make_pipeline(rng, table, fids, payload, xlen):
+    """[(id, values, slot)]: slot takes the previous call's result, or None"""
+    steps, prev_ret = [], None
+    for fid in fids:
+        types = table[fid]["types"]
+        steps.append((fid, make_args(rng, types, payload, xlen),
+                      forward_slot(types, prev_ret)))
+        prev_ret = table[fid]["ret"]
+    return steps
+
+
+def expected_pipeline(table, steps, xlen):
+    prev = None
+    for fid, values, slot in steps:
+        if slot is not None:
+            values = list(values)
+            values[slot] = convert(prev, table[fid]["types"][slot], xlen)
+        prev = expected_result(table[fid], values, xlen)
+        if prev is None:
+            return None
+    return prev
+
+
+def encode_pipeline(table, steps):
+    """The whole pipeline as one chain; results alternate between two slots."""
+    insns = []
+    for k, (fid, values, slot) in enumerate(steps):
+        types = table[fid]["types"]
+        operands = [operand_result((k - 1) % 2) if i == slot
+                    else operand_const(t, v)
+                    for i, (t, v) in enumerate(zip(types, values))]
+        insns.append(chain_insn(CHAIN_CALL, dst=k % 2, func_id=fid,
+                                operands=operands))
+    insns.append(chain_insn(CHAIN_EMIT,
+                            operands=[operand_result((len(steps) - 1) % 2)]))
+    return encode_chain(insns)
+
+
+def run_pipeline(target, table, steps, xlen, round_trips):
+    """Final result of the pipeline: one CHAIN request, or one CALL per step"""
+    if not round_trips:
+        reply = target.request(OP_CHAIN, encode_pipeline(table, steps))
+        status, _, calls, outputs = parse_chain_reply(reply)
+        if status != 0 or calls != len(steps):
+            raise RuntimeError("chain failed with status %d after %d calls"
+                               % (status, calls))
+        return outputs[0]
+    prev = None
+    for fid, values, slot in steps:
+        types = table[fid]["types"]
+        if slot is not None:
+            values = list(values)
+            values[slot] = convert(prev, types[slot], xlen)
+        reply = target.request(OP_CALL, struct.pack("<H", 1) +
+                               encode_call(fid, types, values))
+        fmt = RET_FORMAT.get(table[fid]["ret"])
+        prev = struct.unpack_from(fmt, reply, 2)[0] if fmt else None
+    return prev
+
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return 0.0
+    rank = math.ceil(p / 100.0 * len(sorted_values)) - 1  # nearest-rank
+    return sorted_values[max(0, min(len(sorted_values) - 1, rank))]
+
+
+def build_mix(table, spec):
+    names = {e["name"]: i for i, e in enumerate(table)}
+    if not spec:
+        return list(range(len(table))), [1.0] * len(table)
+    ids, weights = [], []
+    for item in spec.split(","):
+        name, _, weight = item.partition(":")
+        if name not in names:
+            raise SystemExit("unknown function '%s' (target has: %s)"
+                             % (name, ", ".join(names)))
+        ids.append(names[name])
+        weights.append(float(weight) if weight else 1.0)
+    return ids, weights
+
+
+def run(target, args):
+    xlen = target.wait_hello()
+    table = parse_list(target.request(OP_LIST))
+    ids, weights = build_mix(table, args.mix)
+    rng = random.Random(args.seed)
+    pipeline = args.chain or args.round_trips
+    if args.chain and args.batch >= MAX_CHAIN_INSNS:
+        raise SystemExit("--chain supports at most %d calls per request"
+                         % (MAX_CHAIN_INSNS - 1))
+
+    latencies, calls, errors = [], 0, 0
+    tx0 = rx0 = 0
+    start = 0.0
+    for n in range(args.warmup + args.requests):
+        if n == args.warmup:
+            tx0, rx0 = target.tx_bytes, target.rx_bytes
+            start = time.perf_counter()
+        if pipeline:
+            steps = make_pipeline(rng, table,
+                                  rng.choices(ids, weights, k=args.batch),
+                                  args.payload, xlen)
+            t0 = time.perf_counter()
+            result = run_pipeline(target, table, steps, xlen, args.round_trips)
+            t1 = time.perf_counter()
+            if not matches(result, expected_pipeline(table, steps, xlen)):
+                errors += 1
+            if n >= args.warmup:
+                latencies.append((t1 - t0) * 1e6)
+                calls += len(steps)
+            continue
+
+        batch = [(fid, make_args(rng, table[fid]["types"], args.payload,
+                                 xlen))
+                 for fid in rng.choices(ids, weights, k=args.batch)]
+        payload = struct.pack("<H", len(batch)) + b"".join(
+            encode_call(fid, table[fid]["types"], values)
+            for fid, values in batch)
+
+        t0 = time.perf_counter()
+        reply = target.request(OP_CALL, payload)
+        t1 = time.perf_counter()
+
+        pos = 2
+        for fid, values in batch:
+            fmt = RET_FORMAT.get(table[fid]["ret"])
+            result = None
+            if fmt:
+                (result,) = struct.unpack_from(fmt, reply, pos)
+                pos += struct.calcsize(fmt)
+            if not check(table[fid], values, result, xlen):
+                errors += 1
+        if n >= args.warmup:
+            latencies.append((t1 - t0) * 1e6)
+            calls += len(batch)
+    elapsed = time.perf_counter() - start
+
+    latencies.sort()
+    return {
+        "mix": args.mix or "all",
+        "mode": ("round-trips" if args.round_trips else
+                 "chain" if args.chain else "batch"),
+        "batch": args.batch,
+        "payload": args.payload,
+        "xlen": xlen * 8,
+        "requests": args.requests,
+        "calls": calls,
+        "seconds": round(elapsed, 6),
+        "calls_per_s": round(calls / elapsed, 1) if elapsed else 0.0,
+        "p50_us": round(percentile(latencies, 50), 1),
+        "p99_us": round(percentile(latencies, 99), 1),
+        "p999_us": round(percentile(latencies, 99.9), 1),
+        "bytes_per_call": round((target.tx_bytes - tx0 + target.rx_bytes - rx0)
+                                / calls, 1) if calls else 0.0,
+        "errors": errors,
+    }
+
+
+def write_report(report, fmt, path):
+    if fmt == "json":
+        text = json.dumps(report, indent=2) + "\n"
+        if path:
+            with open(path, "a") as f:
+                f.write(text)
+        else:
+            sys.stdout.write(text)
+        return
+    # CSV: 追加到已有文件时不重复表头，便于积累回归数据
+    new_file = not path or not os.path.exists(path) or os.path.getsize(path) == 0
+    f = open(path, "a", newline="") if path else sys.stdout
+    writer = csv.DictWriter(f, fieldnames=list(report))
+    if new_file:
+        writer.writeheader()
+    writer.writerow(report)
+    if path:
+        f.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf")
+    parser.add_argument("--qemu", default="qemu-system-riscv32")
+    parser.add_argument("--qemu-opts", default="",
+                        help="extra QEMU options")
+    parser.add_argument("--cmd", help="target command instead of QEMU "
+                        "(must speak the protocol on stdin/stdout)")
+    parser.add_argument("--mix", default="",
+                        help="name:weight,... (default: every function, "
+                        "equal weights)")
+    parser.add_argument("--batch", type=int, default=1,
+                        help="calls per request")
+    mode = parser.add_mutually_exclusive_group()
+    mode.add_argument("--chain", action="store_true",
+                      help="make each batch a dependent pipeline and send it "
+                      "as one CHAIN request")
+    mode.add_argument("--round-trips", action="store_true",
+                      help="the same pipeline as --chain, one CALL request "
+                      "per call")
+    parser.add_argument("--payload", type=int, default=64,
+                        help="bytes per POINTER argument")
+    parser.add_argument("--requests", type=int, default=1000)
+    parser.add_argument("--warmup", type=int, default=50)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--format", choices=("csv", "json"), default="csv")
+    parser.add_argument("--output", help="append the report to this file")
+    args = parser.parse_args()
+
+    if args.cmd:
+        argv = shlex.split(args.cmd)
+    else:
+        argv = [args.qemu, "-machine", "virt", "-display", "none",
+                "-monitor", "none", "-no-reboot", "-bios", "none",
+                "-serial", "stdio"] + shlex.split(args.qemu_opts) + [
+                    "-kernel", args.elf]
+    target = Target(argv)
+    try:
+        report = run(target, args)
+    finally:
+        target.close()
+    write_report(report, args.format, args.output)
+    return 1 if report["errors"] else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())